@@ -0,0 +1,209 @@
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "../microsat.h"
+
+enum BENCH { QUERIES = 200, QUERY_SIZE = 5, SESSION = 20, ASSUMPTIONS = 2, RUNS = 3 }; // Queries per formula, clicks per
+                                                         // session, literals per assumption query, best of RUNS runs
+const double TOLERANCE = 0.25, NOISE = 0.02;            // A regression is slower by 25 percent and 20 ms
+
+struct instance { char* family; int size, seed; };       // The generated formulas: name family-size-seed
+
+struct instance instances[] = {
+  { "random", 125, 1 }, { "random", 150, 1 }, { "random", 150, 2 }, { "random", 175, 1 },
+  { "pigeon", 8, 0 }, { "pigeon", 9, 0 }, { "pigeon", 10, 0 },
+  { "config", 20000, 1 }, { "config", 100000, 1 }, { "config", 500000, 1 } };
+
+struct result { double time, conflicts, propagations; long rss; char status[16]; };
+
+unsigned long long state;                                // Deterministic random numbers (splitmix64), so that the
+unsigned long long nextRandom () {                       // formulas are the same on every platform
+  unsigned long long z = (state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL; z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31); }
+
+int randomInt (int n) { return (int) (nextRandom () % n); }          // Uniform in 0 .. n-1
+int randomLiteral (int var, int percent) { return randomInt (100) < percent ? var : -var; }
+
+void randomFormula (FILE* out, int n) {                  // Random 3-SAT at the phase transition (ratio 4.26)
+  int m = n * 426 / 100;
+  fprintf (out, "p cnf %i %i\n", n, m);
+  for (int i = 0; i < m; i++) {
+    int a = 1 + randomInt (n), b, c;
+    do b = 1 + randomInt (n); while (b == a);
+    do c = 1 + randomInt (n); while (c == a || c == b);
+    fprintf (out, "%i %i %i 0\n", randomLiteral (a, 50), randomLiteral (b, 50), randomLiteral (c, 50)); } }
+
+void pigeonFormula (FILE* out, int n) {                  // n+1 pigeons in n holes; variable i*n+j+1: pigeon i in hole j
+  int i, j, k;
+  fprintf (out, "p cnf %i %i\n", (n+1) * n, (n+1) + n * n * (n+1) / 2);
+  for (i = 0; i <= n; i++) {
+    for (j = 0; j < n; j++) fprintf (out, "%i ", i*n + j+1);
+    fprintf (out, "0\n"); }
+  for (j = 0; j < n; j++)
+    for (i = 0; i <= n; i++)
+      for (k = i+1; k <= n; k++) fprintf (out, "-%i -%i 0\n", i*n + j+1, k*n + j+1); }
+
+void configFormula (FILE* out, int n) {                  // A feature model: each feature requires a parent among
+  int v, m = 0, size = 0, *clauses = malloc (sizeof (int) * 16 * n);  // the 20 previous ones, some parents need one
+  clauses[size++] = 1; clauses[size++] = 0; m++;                     // of three children, and some features exclude
+  for (v = 2; v <= n; v++) {                                         // each other; feature 1 is the root
+    int parent = v - 1 - randomInt (v - 1 < 20 ? v - 1 : 20);
+    clauses[size++] = -v; clauses[size++] = parent; clauses[size++] = 0; m++;
+    if (randomInt (100) < 10) {
+      clauses[size++] = -parent;
+      for (int w = v; w <= v+2 && w <= n; w++) clauses[size++] = w;
+      clauses[size++] = 0; m++; }
+    if (randomInt (100) < 5) {
+      int a = 2 + randomInt (n-1), b = 2 + randomInt (n-1);
+      if (a != b) { clauses[size++] = -a; clauses[size++] = -b; clauses[size++] = 0; m++; } } }
+  fprintf (out, "c v%i", QUERY_SIZE);
+  for (int i = 0; i < QUERY_SIZE; i++) fprintf (out, " %i", randomLiteral (2 + randomInt (n-1), 70));
+  fprintf (out, "\np cnf %i %i\n", n, m);
+  for (int i = 0; i < size; i++) fprintf (out, clauses[i] ? "%i " : "0\n", clauses[i]);
+  free (clauses); }
+
+void generate (struct instance* I, char* path) {         // Write the formula unless the file exists
+  struct stat info; if (!stat (path, &info)) return;
+  FILE* out = fopen (path, "w"); if (!out) printf ("c CANNOT WRITE %s\n", path), exit (ERROR);
+  state = I->seed * 1000003ULL + I->size;
+  if      (!strcmp (I->family, "random")) randomFormula (out, I->size);
+  else if (!strcmp (I->family, "pigeon")) pigeonFormula (out, I->size);
+  else                                     configFormula (out, I->size);
+  fclose (out); }
+
+int satisfied (struct solver* S, int* lits, int n) {    // Does the model satisfy lits and the irredundant clauses?
+  int i, size;
+  for (i = 0; i < n; i++) if (S->model[abs (lits[i])] != (lits[i] > 0)) return 0;
+  for (i = S->mem_clauses + 2; i < S->mem_fixed; i += size + 3) {
+    int sat = 0;
+    for (size = 0; S->DB[i + size]; size++) sat |= S->model[abs (S->DB[i + size])] == (S->DB[i + size] > 0);
+    if (!sat) return 0; }
+  return 1; }
+
+void measure (char* path, char* mode, struct result* R) { // Run one mode on a fresh solver (in a child process)
+  struct solver S; double start = seconds ();
+  if (parse (&S, path, MODE_PROPAGATE) == UNSAT) { strcpy (R->status, "UNSAT"); return; }
+  if (!strcmp (mode, "solve")) {
+    start = seconds ();
+    strcpy (R->status, solve (&S) == SAT ? "SAT" : "UNSAT");
+    R->time = seconds () - start; }
+  else if (!strcmp (mode, "assuming")) {                   // "assuming" times solveAssuming on random assumptions;
+    int lits[ASSUMPTIONS], sat = 0;                        // each model must satisfy them and the clauses
+    state = 42; R->time = 0;
+    for (int q = 0; q < QUERIES; q++) {
+      for (int i = 0; i < ASSUMPTIONS; i++) lits[i] = randomLiteral (1 + randomInt (S.nVars), 50);
+      start = seconds ();
+      int result = solveAssuming (&S, lits, ASSUMPTIONS);
+      R->time += seconds () - start;
+      if (result == SAT && !satisfied (&S, lits, ASSUMPTIONS)) { strcpy (R->status, "BADMODEL"); break; }
+      sat += result == SAT; }
+    if (strcmp (R->status, "BADMODEL")) sprintf (R->status, "%i/%i", sat, QUERIES); }
+  else if (!strcmp (mode, "preprocess")) {                 // "preprocess" times preprocess and the queries on the
+    struct solver T; int lits[QUERY_SIZE], buildable = 0, same = 1; // simplified formula T, whose answers must be
+    parse (&T, path, MODE_PROPAGATE);                      // those of S: the status and, unless the query
+    start = seconds (); preprocess (&T, NULL, 0, 0); R->time = seconds () - start; // conflicts, the implied literals
+    int *a = allocate (S.nVars + 1), *b = allocate (S.nVars + 1);
+    state = 42;
+    for (int q = 0; q < QUERIES && same; q++) {
+      for (int i = 0; i < QUERY_SIZE; i++) lits[i] = randomLiteral (1 + randomInt (S.nVars), 70);
+      int conflict = evaluateDecisions (&S, lits, QUERY_SIZE) == UNSAT, status = !conflict && evaluateBuildability (&S);
+      int n = impliedLiterals (&S, a); backtrack (&S);
+      start = seconds ();
+      int conflictT = evaluateDecisions (&T, lits, QUERY_SIZE) == UNSAT, statusT = !conflictT && evaluateBuildability (&T);
+      R->time += seconds () - start;
+      int m = impliedLiterals (&T, b); backtrack (&T);
+      same = status == statusT && conflict == conflictT && (conflict || (n == m && !memcmp (a, b, sizeof (int) * n)));
+      buildable += statusT; }
+    if (same) sprintf (R->status, "%i/%i", buildable, QUERIES); else strcpy (R->status, "DIFFERS");
+    free (a); free (b); freeSolver (&T); }
+  else {                                                   // "decisions" times evaluateDecisions, "buildability"
+    int lits[SESSION], buildable = 0, n = 0;               // times evaluateBuildability, on the same queries;
+    int session = !strcmp (mode, "session");               // "session" times evaluateDecisions on queries that
+    state = 42; R->time = 0;                               // extend the previous one by a literal (a click)
+    for (int q = 0; q < QUERIES; q++) {
+      int* query = lits;
+      if (session) { if (n == SESSION) n = 0; lits[n++] = randomLiteral (1 + randomInt (S.nVars), 70); }
+      else if (q == 0) query = S.assignments, n = S.nAssignments;    // The "c v" line first, then random ones
+      else for (n = 0; n < QUERY_SIZE; n++) lits[n] = randomLiteral (1 + randomInt (S.nVars), 70);
+      start = seconds ();
+      int status = evaluateDecisions (&S, query, n);
+      if (strcmp (mode, "buildability")) R->time += seconds () - start;
+      start = seconds ();
+      if (status == SAT && evaluateBuildability (&S)) buildable++;
+      if (!strcmp (mode, "buildability")) R->time += seconds () - start;
+      backtrack (&S);
+      if (session && status == UNSAT) n--; }               // Take back a click that conflicts
+    sprintf (R->status, "%i/%i", buildable, QUERIES); }
+  R->conflicts = S.nConflicts;                             // Propagations of evaluateDecisions (or of solve)
+  R->propagations = strcmp (mode, "buildability") ? S.stats.propagations : 0;
+  freeSolver (&S); }
+
+void run (char* path, char* mode, struct result* R) {    // Best of RUNS runs; the peak RSS of the last child
+  R->time = -1;
+  for (int i = 0; i < RUNS; i++) {
+    int fd[2]; struct rusage usage; struct result child = { 0 };
+    if (pipe (fd)) printf ("c PIPE ERROR\n"), exit (ERROR);
+    pid_t pid = fork ();
+    if (!pid) {
+      close (fd[0]); measure (path, mode, &child);
+      _exit (write (fd[1], &child, sizeof (child)) == sizeof (child) ? OK : ERROR); }
+    close (fd[1]);
+    if (read (fd[0], &child, sizeof (child)) != sizeof (child)) printf ("c %s %s CRASHED\n", path, mode), exit (ERROR);
+    close (fd[0]); wait4 (pid, NULL, 0, &usage);
+    if (R->time < 0 || child.time < R->time) *R = child;
+    R->rss = usage.ru_maxrss; } }
+
+char* lookup (FILE* file, char* name, char* mode, char* line, int size) { // The rest of the line of an instance
+  char n[64], m[16]; int k;                                                 // and mode in a results file, or NULL
+  if (!file) return NULL;
+  rewind (file);
+  while (fgets (line, size, file))
+    if (sscanf (line, "%63s %15s %n", n, m, &k) == 2 && !strcmp (n, name) && !strcmp (m, mode)) return line + k;
+  return NULL; }
+
+int main (int argc, char** argv) {                        // Usage: bench [--save] [BASELINE]
+  int save = argc > 1 && !strcmp (argv[1], "--save"), wrong = 0, slower = 0;
+  char* baseline = argc > 1 + save ? argv[1 + save] : "bench/baseline.txt";    // Times of this machine (not in git)
+  char* expected = "bench/expected.txt";                                       // Results of every machine (in git)
+  char* modes[] = { "solve", "decisions", "buildability", "session", "assuming", "preprocess" }, path[256], name[64], line[256];
+  FILE* old = save ? NULL : fopen (baseline, "r"), *results = fopen (expected, "r");
+  FILE* new = save ? fopen (baseline, "w") : NULL;
+  if (save && !new) printf ("c CANNOT WRITE %s\n", baseline), exit (ERROR);
+  if (!results) printf ("c CANNOT READ %s\n", expected), exit (ERROR);
+  mkdir ("bench/instances", 0755);
+
+  printf ("c %-20s %-12s %9s %12s %14s %9s %12s %s\n",
+          "instance", "mode", "time (s)", "conflicts/s", "propagations/s", "RSS (MB)", "result", "baseline");
+  for (int i = 0; i < (int) (sizeof (instances) / sizeof (*instances)); i++) {
+    struct instance* I = &instances[i];
+    sprintf (name, "%s-%i-%i", I->family, I->size, I->seed);
+    sprintf (path, "bench/instances/%s.cnf", name); generate (I, path);
+    for (int m = 0; m < 6; m++) {
+      if (m == 4 ? strcmp (I->family, "random") || I->size > 150    // Assumptions on small random formulas,
+                 : m > 0 && strcmp (I->family, "config")) continue;  // queries only with a "c v" line
+      struct result R; run (path, modes[m], &R);
+      double time = R.time > 1e-9 ? R.time : 1e-9, before = -1; char status[16] = "", verdict[64] = "", *rest;
+      if ((rest = lookup (results, name, modes[m], line, sizeof (line))) && sscanf (rest, "%15s", status) == 1
+          && strcmp (status, R.status)) sprintf (verdict, "WRONG (expected %s)", status), wrong++;
+      else if (!rest) sprintf (verdict, "NEW (not in %s)", expected);
+      else if ((rest = lookup (old, name, modes[m], line, sizeof (line))) && sscanf (rest, "%lf", &before) == 1) {
+        if (R.time > before * (1 + TOLERANCE) + NOISE) sprintf (verdict, "REGRESSION (%.3f s)", before), slower++;
+        else sprintf (verdict, "%+.0f%%", before > 0 ? 100 * (R.time - before) / before : 0); }
+      printf ("c %-20s %-12s %9.3f %12.0f %14.0f %9.1f %12s %s\n", name, modes[m], R.time,
+              R.conflicts / time, R.propagations / time, R.rss / 1024.0, R.status, verdict);
+      fflush (stdout);
+      if (new) fprintf (new, "%s %s %.6f %s\n", name, modes[m], R.time, R.status); } }
+
+  printf ("c %i wrong results against %s\n", wrong, expected); fclose (results);
+  if (new) fclose (new), printf ("c baseline saved to %s\n", baseline);
+  if (old) fclose (old), printf ("c %i regressions against %s\n", slower, baseline);
+  else if (!save) printf ("c no baseline %s of this machine (record one with make bench-baseline)\n", baseline);
+  return wrong ? ERROR : OK; }                           // Times differ between machines: only results fail
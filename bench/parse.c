@@ -0,0 +1,20 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "../microsat.h"
+
+double now () {                                                           // Monotonic time in seconds
+  struct timespec t; clock_gettime (CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9; }
+
+int main (int argc, char** argv) {                                        // Measure the parse throughput in MB/s
+  if (argc == 1) printf ("Usage: parse DIMACS_FILE...\n"), exit (OK);
+  for (int i = 1; i < argc; i++) {
+    struct solver S; struct stat info;
+    double size = stat (argv[i], &info) ? 0 : info.st_size / 1e6, start = now ();
+    parse (&S, argv[i], MODE_PROPAGATE);
+    double time = now () - start;
+    printf ("c %s: %.1f MB, %i clauses in %.3f s, %.1f MB/s\n", argv[i], size, S.nClauses, time, time > 0 ? size / time : 0);
+    freeSolver (&S); } }
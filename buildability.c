@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "microsat.h"
+
+struct completion {                   // The irredundant clauses of the DB: clause c at offset[c] has count[c] literals
+  int nClauses, *offset, *count;      // that are true in the completion (undecided = false) of the top-level assignment
+  int *first, *occurs;                // Clauses of literal lit: occurs[first[lit]] .. occurs[first[lit+1]-1]
+  int nFalsified, root, end;          // Clauses with count zero, top-level literals counted, S->mem_fixed when built
+  int *seen;                          // Per variable: already listed as undecided
+  struct list clauses, variables; };  // The result of unsatisfiedClauses
+
+static int value (struct solver* S, int lit) {               // Is lit true in the completion undecided = false?
+  return S->false[-lit] || (lit < 0 && !S->false[lit]); }
+
+static void update (struct completion* C, int lit, int delta) { // Add delta to the counts of the clauses of lit
+  for (int* p = C->occurs + C->first[lit]; p < C->occurs + C->first[lit+1]; p++) {
+    int* count = C->count + *p;
+    if (*count == 0) C->nFalsified--;
+    *count += delta;
+    if (*count == 0) C->nFalsified++; } }
+
+static void apply (struct completion* C, int* from, int* to, int sign) { // Count (sign 1) or uncount (sign -1) the
+  for (int* p = from; p < to; p++)                           // trail literals from .. to; only variables that are
+    if (*p < 0) update (C, -*p, sign), update (C, *p, -sign); } // true differ from the completion
+
+static struct completion* build (struct solver* S) {         // Count the literals of all irredundant clauses
+  int i, j, size, n = S->nVars, from = S->mem_clauses;
+  struct completion* C = zeroed (1, sizeof (struct completion));
+  C->first = (int*) zeroed (2*n+3, sizeof (int)) + n;
+  C->seen = zeroed (n+1, sizeof (int));
+  for (i = from + 2; i < S->mem_fixed; i += size + 3, C->nClauses++)   // Count the clauses and the occurrences
+    for (size = 0; S->DB[i + size]; size++) C->first[S->DB[i + size]]++;
+  for (i = -n + 1; i <= n + 1; i++) C->first[i] += C->first[i-1];      // The end of each occurrence list
+  C->offset = reallocate (NULL, sizeof (int) * (C->nClauses + 1));
+  C->count  = reallocate (NULL, sizeof (int) * (C->nClauses + 1));
+  C->occurs = reallocate (NULL, sizeof (int) * (C->first[n+1] + 1));
+  for (i = from + 2, j = 0; i < S->mem_fixed; i += size + 3, j++) {    // Fill the lists from the back, so that
+    C->offset[j] = i; C->count[j] = 0;                                 // first[lit] ends up at their start
+    for (size = 0; S->DB[i + size]; size++) {
+      int lit = S->DB[i + size];
+      C->occurs[--C->first[lit]] = j; C->count[j] += value (S, lit); }
+    if (!C->count[j]) C->nFalsified++; }
+  apply (C, S->forced, S->assigned, -1);                     // Only keep the top-level assignment
+  C->root = S->forced - S->falseStack; C->end = S->mem_fixed;
+  return C; }
+
+void freeCompletion (struct solver* S) {
+  struct completion* C = S->completion;
+  if (!C) return;
+  free (C->first - S->nVars); free (C->seen); free (C->offset); free (C->count); free (C->occurs);
+  free (C->clauses.data); free (C->variables.data); free (C);
+  S->completion = NULL; }
+
+static struct completion* enter (struct solver* S) {         // Count the trail of the current query
+  struct completion* C = S->completion;
+  if (C && C->end != S->mem_fixed) freeCompletion (S), C = NULL; // Irredundant clauses were added: start over
+  if (!C) C = S->completion = build (S);
+  apply (C, S->falseStack + C->root, S->forced, 1);          // New top-level units stay counted
+  C->root = S->forced - S->falseStack;
+  apply (C, S->forced, S->assigned, 1);
+  return C; }
+
+static void leave (struct solver* S) { apply (S->completion, S->forced, S->assigned, -1); }
+
+int completionSatisfied (struct solver* S) {                 // Does the completion satisfy all clauses? The cost is
+  int result = !enter (S)->nFalsified;                       // the occurrences of the variables that the query makes
+  leave (S);                                                 // true, not the size of the formula
+  return result && (!S->nEliminated || eliminatedSatisfied (S)); }
+
+static void list (struct solver* S, int* clause, int size) { // Add a falsified clause and its undecided variables
+  struct completion* C = S->completion;
+  for (int i = 0; i < size; i++) {
+    int var = abs (clause[i]);
+    push (&C->clauses, clause[i]);
+    if (!S->false[var] && !S->false[-var] && !C->seen[var]) C->seen[var] = 1, push (&C->variables, var); }
+  push (&C->clauses, 0); }
+
+int unsatisfiedClauses (struct solver* S, int** clauses, int** variables) { // List the clauses that the completion
+  struct completion* C = enter (S); int n = 0, size;         // falsifies, each terminated by 0, and their undecided
+  C->clauses.size = C->variables.size = 0;                   // variables (terminated by 0)
+  for (int c = 0; C->nFalsified && c < C->nClauses; c++)
+    if (!C->count[c]) {
+      int* clause = S->DB + C->offset[c];
+      for (size = 0; clause[size]; size++);
+      list (S, clause, size); n++; }
+  leave (S);
+  int* p = S->eliminated + S->nEliminated;                   // The saved clauses of eliminated variables
+  while (S->nEliminated && p > S->eliminated) {
+    int i; size = *(--p); p -= size;
+    for (i = 0; i < size && !value (S, p[i]); i++);
+    if (i == size) list (S, p, size), n++; }
+  for (int i = 0; i < C->variables.size; i++) C->seen[C->variables.data[i]] = 0;
+  push (&C->variables, 0); C->variables.size--;
+  *clauses = C->clauses.data; *variables = C->variables.data;
+  return n; }
@@ -0,0 +1,137 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "microsat.h"
+
+enum SERVE_MODES { MODE_SERVE = 2, MODE_SOCKET = 3 };
+enum STATS_FORMATS { STATS_NONE = 0, STATS_TEXT = 1, STATS_JSON = 2 };
+
+int MODE = MODE_SOLVE, FORMAT = STATS_NONE, EXPLAIN = 0;
+
+double now () {                                                           // Monotonic time in milliseconds
+  struct timespec t; clock_gettime (CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e3 + t.tv_nsec * 1e-6; }
+
+void report (struct solver* S, FILE* out) {                               // Print the statistics if requested; JSON goes
+  if (FORMAT == STATS_TEXT) printStatistics (S, out, 0);                  // to stderr to keep stdout in DIMACS format
+  if (FORMAT == STATS_JSON) printStatistics (S, stderr, 1); }
+
+void explain (struct solver* S, FILE* out) {                              // Print the clauses that the completion
+  int *clauses, *variables, n = unsatisfiedClauses (S, &clauses, &variables); // falsifies and their undecided variables
+  for (int i = 0; i < n; i++, clauses++) {
+    fprintf (out, "c unsatisfied");
+    for (; *clauses; clauses++) fprintf (out, " %i", *clauses);
+    fprintf (out, " 0\n"); }
+  fprintf (out, "c undecided");
+  for (; *variables; variables++) fprintf (out, " %i", *variables);
+  fprintf (out, "\n"); }
+
+int readAssignment (struct solver* S, char* line, int** lits, int* size) { // Parse a "c v<N> ..." line into lits
+  int n, i, k; char* end;                                                  // Returns the number of literals, -1 if it
+  if (line[strspn (line, " \t\r\n")] == 0) return -3;                      // is not an assignment line, -2 if invalid,
+  if (sscanf (line, " c v%i%n", &n, &k) < 1) return -1;                   // -3 if blank
+  if (n < 0 || n > S->nVars) return -2;                                    // Check n before allocating
+  if (n > *size) {
+    *size = n; *lits = reallocate (*lits, sizeof (int) * n); }
+  for (line += k, i = 0; i < n; i++, line = end) {
+    (*lits)[i] = strtol (line, &end, 10);
+    if (end == line || !(*lits)[i] || abs ((*lits)[i]) > S->nVars) return -2; }
+  return n; }
+
+void serve (struct solver* S, FILE* in, FILE* out) {                      // Answer assignment queries until EOF
+  char* line = 0; size_t length = 0; int n, size = 0, nQueries = 0;       // Requests may be pipelined: the replies
+  int *lits = 0, *implied = allocate (S->nVars + 1);                      // are written in the order of the requests
+  double total = 0, max = 0;
+  while (getline (&line, &length, in) > 0) {
+    double start = now ();
+    if ((n = readAssignment (S, line, &lits, &size)) == -3) continue;     // Skip blank lines; any other line gets a
+    if (n < 0) {                                                          // reply, so that the replies stay in order
+      fprintf (out, "c %s\ns ERROR\n", n == -1 ? "NOT AN ASSIGNMENT" : "INVALID ASSIGNMENT"); fflush (out);
+      if (ferror (out)) break;
+      continue; }
+    int status = query (S, lits, n), nImplied = impliedLiterals (S, implied);
+    fprintf (out, "v");
+    for (int i = 0; i < nImplied; i++) fprintf (out, " %i", implied[i]);
+    fprintf (out, "\n");
+    if (EXPLAIN && status == INCOMPLETE) explain (S, out);
+    backtrack (S);                                                        // Undo the assignments of this query only
+    fprintf (out, "s %s\n", status == BUILDABLE ? "BUILDABLE" : "INCOMPLETE"); fflush (out);
+    double time = now () - start; total += time; if (time > max) max = time; nQueries++;
+    if (ferror (out)) break; }                                            // The client is gone: drop the connection
+  if (!ferror (out)) {
+    fprintf (out, "c %i queries, %.3f ms total, %.3f ms average, %.3f ms maximum\n",
+             nQueries, total, nQueries ? total / nQueries : 0, max);
+    fprintf (out, "c arena: %.1f MB used, %.1f MB peak, %.1f MB allocated\n",
+             S->mem_used * 4e-6, S->mem_peak * 4e-6, S->mem_max * 4e-6); fflush (out);
+    report (S, out); }
+  free (line); free (lits); free (implied); }
+
+void serveSocket (struct solver* S, char* path) {                         // Serve the connections of a Unix socket
+  struct sockaddr_un address = { .sun_family = AF_UNIX };                 // one after another
+  struct stat info; int fd = socket (AF_UNIX, SOCK_STREAM, 0);
+  strncpy (address.sun_path, path, sizeof (address.sun_path) - 1);
+  if (!lstat (path, &info) && S_ISSOCK (info.st_mode)) unlink (path);     // Replace a stale socket, but no other file
+  signal (SIGPIPE, SIG_IGN);                                              // A client that closes early only ends its
+  if (fd < 0 || bind (fd, (struct sockaddr*) &address, sizeof (address)) || listen (fd, 16))
+    printf ("c SOCKET ERROR\n"), exit (ERROR);
+  for (;;) {
+    int connection = accept (fd, 0, 0); if (connection < 0) continue;
+    FILE *in = fdopen (connection, "r"), *out = fdopen (dup (connection), "w");
+    serve (S, in, out); fclose (in); fclose (out); } }                    // own connection (write errors, see serve)
+
+int main (int argc, char** argv) {                                                                          // The main procedure
+  char* path = 0; int nThreads = 1, seed = 0, simplify = 0;                                                 // The options of the modes
+  long maxConflicts = 0, maxProps = 0, timeout = 0; double start = seconds ();                              // and the limits of solve
+  if (argc == 1) printf ("Usage: microsat [--version] [--propagate | --serve | --socket PATH] [--threads N] [--seed N] [--preprocess] [--stats[=json]] [--explain] [--max-conflicts N] [--max-props N] [--timeout-ms N] DIMACS_FILE\n"), exit (OK); // Print usage if no argument is given
+  if (!strcmp (argv[1], "--version")) printf (VERSION "\n"), exit (OK);                                     // Print version if argument --version is given
+  for (; argc > 2 && !strncmp (argv[1], "--", 2); argc--, argv++) {                                         // Parse the options before the file
+    if (!strcmp (argv[1], "--propagate")) MODE = MODE_PROPAGATE;                                            // Set mode to propagate an assignment
+    else if (!strcmp (argv[1], "--serve")) MODE = MODE_SERVE;                                               // Set mode to answer queries from stdin
+    else if (!strcmp (argv[1], "--socket") && argc > 3) MODE = MODE_SOCKET, path = argv[2], argc--, argv++; // Set mode to answer queries from a socket
+    else if (!strcmp (argv[1], "--threads") && argc > 3) nThreads = atoi (argv[2]), argc--, argv++;         // Solve with a portfolio of N threads
+    else if (!strcmp (argv[1], "--seed") && argc > 3) seed = atoi (argv[2]), argc--, argv++;                // Seed of the portfolio diversification
+    else if (!strcmp (argv[1], "--preprocess")) simplify = 1;                                              // Simplify the formula before solving
+    else if (!strcmp (argv[1], "--stats")) FORMAT = STATS_TEXT;                                             // Print statistics as "c" lines
+    else if (!strcmp (argv[1], "--stats=json")) FORMAT = STATS_JSON;                                        // or as JSON (on stderr)
+    else if (!strcmp (argv[1], "--explain")) EXPLAIN = 1;                                                   // List the unsatisfied clauses if INCOMPLETE
+    else if (!strcmp (argv[1], "--max-conflicts") && argc > 3) maxConflicts = atol (argv[2]), argc--, argv++; // Stop solving with UNKNOWN after N conflicts,
+    else if (!strcmp (argv[1], "--max-props") && argc > 3) maxProps = atol (argv[2]), argc--, argv++;       // N propagations
+    else if (!strcmp (argv[1], "--timeout-ms") && argc > 3) timeout = atol (argv[2]), argc--, argv++;       // or N milliseconds (from the start)
+    else printf ("c UNKNOWN OPTION %s\n", argv[1]), exit (ERROR); }
+
+  struct solver S;                                                                        // Create the solver datastructure
+  if (parse (&S, argv[1], MODE) == UNSAT) report (&S, stdout), printf("s UNSATISFIABLE\n"), exit (UNSAT); // Parse the DIMACS file
+  if (simplify && preprocess (&S, NULL, 0, MODE == MODE_SOLVE) == UNSAT)                 // Queries are answered as on
+    report (&S, stdout), printf("s UNSATISFIABLE\n"), exit (UNSAT);                      // the original formula
+
+  if (MODE == MODE_SERVE) serve (&S, stdin, stdout), exit (OK);                           // Answer "c v" lines until EOF
+  if (MODE == MODE_SOCKET) serveSocket (&S, path);                                        // Answer "c v" lines of each connection
+
+  if (MODE == MODE_SOLVE) {
+    if (maxConflicts > 0) S.maxConflicts = maxConflicts < INT_MAX ? maxConflicts : INT_MAX; // Set the limits of solve
+    if (maxProps > 0) S.maxPropagations = S.stats.propagations + maxProps;                 // (parse and preprocess
+    if (timeout > 0) S.deadline = start + timeout * 1e-3;                                  // already propagated)
+    int result = (nThreads > 1) ? solvePortfolio (&S, nThreads, seed) : solve (&S);       // Solve within the limits
+    report (&S, stdout);
+    if (result == UNKNOWN) {                                                              // A limit is reached: the
+      int n = forcedUnits (&S, S.buffer); printf ("v");                                   // top-level units are all
+      for (int i = 0; i < n; i++) printf (" %i", S.buffer[i]);                            // that is known so far
+      printf ("\ns UNKNOWN\n"); exit (UNKNOWN); }
+    if (result == UNSAT) printf("s UNSATISFIABLE\n"), exit (UNSAT);
+    else printf("s SATISFIABLE\n"), exit (SAT); }                                         // and print whether the formula has a solution
+  else if (MODE == MODE_PROPAGATE) {
+    int status = evaluateDecisions (&S, S.assignments, S.nAssignments); printDecisions (&S);
+    status = (status == SAT && evaluateBuildability (&S));
+    if (EXPLAIN && !status) explain (&S, stdout);
+    report (&S, stdout);
+    if (status) printf ("s BUILDABLE\n"), exit (BUILDABLE);
+    else printf ("s INCOMPLETE\n"), exit (INCOMPLETE); } }
@@ -1,17 +1,22 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 
-enum EXIT_CODES { OK = 0, ERROR = 1, SAT = 10, UNSAT = 20, BUILDABLE = 30, INCOMPLETE = 40 };
-enum LITERAL_MARKS { END = -9, MARK = 2, IMPLIED = 6 };
-enum MODES { MODE_SOLVE = 0, MODE_PROPAGATE = 1 };
+#include "microsat.h"
 
-const int MEM_MAX = 1 << 28;
-int MODE = MODE_SOLVE;
+const int MEM_MAX = 1 << 30;                                        // Maximum size of the DB (addressed by int offsets)
+const int CHECK   = 1024;                                           // Propagations between two checks of the limits
 
-struct solver { // The variables in the struct are described in the allocate procedure
-  int  *DB, nVars, nClauses, mem_used, mem_fixed, maxLemmas, nLemmas, *buffer, nConflicts, *model, *reason, *falseStack,
-       *false, *first, *forced, *processed, *assigned, *next, *prev, head, res, fast, slow, nAssignments, *assignments; };
+double seconds () {                                                // Monotonic time in seconds
+  struct timespec t; clock_gettime (CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9; }
 
 void unassign (struct solver* S, int lit) { S->false[lit] = 0; }   // Unassign the literal
 
@@ -26,41 +31,136 @@ void assign (struct solver* S, int* reason, int forced) {          // Make the f
   S->reason[abs (lit)] = 1 + (int) ((reason)-S->DB);               // Set the reason clause of lit
   S->model [abs (lit)] = (lit > 0); }                              // Mark the literal as true in the model
 
+void* zeroed (size_t count, size_t size) {                        // Allocate zeroed memory outside of the DB
+  void* store = calloc (count, size);
+  if (!store && count && size) { printf ("c OUT OF MEMORY\n"); exit (ERROR); }
+  return store; }
+
+void* reallocate (void* array, size_t size) {                      // Resize memory outside of the DB
+  void* store = realloc (array, size);
+  if (!store && size) { printf ("c OUT OF MEMORY\n"); exit (ERROR); }
+  return store; }
+
+int* allocate (int size) { return (int *) zeroed (size, sizeof (int)); } // Zeroed integers outside of the DB
+
+void push (struct list* list, int value) {                         // Append value to a list
+  if (list->size == list->capacity) {
+    list->capacity = list->capacity ? 2 * list->capacity : 16;
+    list->data = reallocate (list->data, sizeof (int) * list->capacity); }
+  list->data[list->size++] = value; }
+
+#ifdef LINKED_WATCHES
 void addWatch (struct solver* S, int lit, int mem) {               // Add a watch pointer to a clause containing lit
   S->DB[mem] = S->first[lit]; S->first[lit] = mem; }               // By updating the database and the pointers
+#else
+void reserve (struct watchList* list, int capacity) {             // Make room for capacity integers in a list
+  list->capacity = capacity;
+  list->data = (int *) reallocate (list->data, sizeof (int) * capacity); }
+
+void addWatch (struct watchList* list, int blocker, int clause) {  // Add a watch (blocker, clause offset) to a list
+  if (list->size + 2 > list->capacity)                             // Double the capacity of a full list
+    reserve (list, list->capacity ? 2 * list->capacity : 8);
+  list->data[list->size++] = blocker; list->data[list->size++] = clause; }
+
+struct watchList* allocateLists (int n) {                          // Allocate empty lists for the literals -n to n
+  return (struct watchList *) zeroed (2*n+1, sizeof (struct watchList)) + n; }
+
+void copyList (struct watchList* to, struct watchList* from) {    // Copy a list to an empty list
+  if (!from->size) return;
+  reserve (to, from->size); to->size = from->size;
+  memcpy (to->data, from->data, sizeof (int) * from->size); }
+
+void removeLemmas (struct solver* S, struct watchList* list) {    // Remove the watches of lemmas from a list
+  int i, j; for (i = j = 0; i < list->size; i += 2)
+    if (list->data[i+1] < S->mem_fixed) {                          // Keep the watches of input clauses
+      list->data[j++] = list->data[i]; list->data[j++] = list->data[i+1]; }
+  list->size = j; }
+#endif
+
+void resizeDB (struct solver* S, long size) {                      // Resize the DB to size integers
+  long unit = S->unit ? S->unit - S->DB : -1;                     // Offsets into the DB stay valid, pointers do not
+  S->DB = (int *) reallocate (S->DB, sizeof (int) * size); S->mem_max = size;
+  if (unit >= 0) S->unit = S->DB + unit; }                         // Rebase the only pointer into the DB
 
 int* getMemory (struct solver* S, int mem_size) {                  // Allocate memory of size mem_size
-  if (S->mem_used + mem_size > MEM_MAX) {                          // In case the code is used within a code base
-    printf ("c OUT OF MEMORY\n"); exit (ERROR); }
+  long needed = (long) S->mem_used + mem_size;
+  if (needed > S->mem_max) {                                       // Grow the DB by doubling its size
+    if (needed > MEM_MAX) { printf ("c OUT OF MEMORY\n"); exit (ERROR); }
+    long size = 2L * S->mem_max; if (size < needed) size = needed; if (size > MEM_MAX) size = MEM_MAX;
+    resizeDB (S, size); }
   int *store = (S->DB + S->mem_used);                              // Compute a pointer to the new memory location
   S->mem_used += mem_size;                                         // Update the size of the used memory
+  if (S->mem_used > S->mem_peak) S->mem_peak = S->mem_used;        // And the peak usage
   return store; }                                                  // Return the pointer
 
-int* addClause (struct solver* S, int* in, int size, int irr) {    // Adds a clause stored in *in of size size
-  int i, used = S->mem_used;                                       // Store a pointer to the beginning of the clause
-  int* clause = getMemory (S, size + 3) + 2;                       // Allocate memory for the clause in the database
-  if (size >  1) { addWatch (S, in[0], used  );                    // If the clause is not unit, then add
-                   addWatch (S, in[1], used+1); }                  // Two watch pointers to the datastructure
+int* storeClause (struct solver* S, int* in, int size, int irr) {  // Adds a clause without watching it (see watchClauses)
+  int i, *clause = getMemory (S, size + 3) + 2;                    // Allocate memory for the clause in the database
   for (i = 0; i < size; i++) clause[i] = in[i]; clause[i] = 0;     // Copy the clause from the buffer to the database
   if (irr) S->mem_fixed = S->mem_used; else S->nLemmas++;          // Update the statistics
+  S->nLevels = 0;                                                  // Cached query levels may miss implications now
+  return clause; }
+
+void watchClauses (struct solver* S, int from) {                   // Watch all clauses stored in the DB after from
+  int i, size;
+#ifdef LINKED_WATCHES
+  for (i = from + 2; i < S->mem_used; i += size + 3) {             // Add two watch pointers to each clause
+    for (size = 0; S->DB[i+size]; size++);
+    if (size > 1) addWatch (S, S->DB[i], i-2), addWatch (S, S->DB[i+1], i-1); }
+#else
+  int n = S->nVars, *nWatches = allocate (2*n+1) + n, *nBinaries = allocate (2*n+1) + n;
+  for (i = from + 2; i < S->mem_used; i += size + 3) {             // Count the watches of each literal first,
+    for (size = 0; S->DB[i+size]; size++);
+    if (size == 2) nBinaries[S->DB[i]]++, nBinaries[S->DB[i+1]]++;
+    if (size >  2) nWatches [S->DB[i]]++, nWatches [S->DB[i+1]]++; }
+  for (i = -n; i <= n; i++) {                                      // so that each list is allocated only once
+    if (nWatches[i])  reserve (&S->watches[i],  2 * (S->watches[i].size  + nWatches[i]));
+    if (nBinaries[i]) reserve (&S->binaries[i], 2 * (S->binaries[i].size + nBinaries[i])); }
+  for (i = from + 2; i < S->mem_used; i += size + 3) {             // Then add the watches
+    for (size = 0; S->DB[i+size]; size++);
+    struct watchList* watches = (size == 2) ? S->binaries : S->watches;
+    if (size > 1) addWatch (&watches[S->DB[i]], S->DB[i+1], i), addWatch (&watches[S->DB[i+1]], S->DB[i], i); }
+  free (nWatches - n); free (nBinaries - n);
+#endif
+  }
+
+int* addClause (struct solver* S, int* in, int size, int irr) {    // Adds a clause stored in *in of size size
+  int* clause = storeClause (S, in, size, irr);                    // Copy the clause to the database
+  int used = (int) (clause - S->DB) - 2;                           // The offset of the beginning of the clause
+#ifdef LINKED_WATCHES
+  if (size >  1) { addWatch (S, clause[0], used  );                // If the clause is not unit, then add
+                   addWatch (S, clause[1], used+1); }              // Two watch pointers to the datastructure
+#else
+  struct watchList* watches = (size == 2) ? S->binaries : S->watches; // Binary clauses get their own implication lists
+  if (size >  1) { addWatch (&watches[clause[0]], clause[1], used+2);  // If the clause is not unit, then add
+                   addWatch (&watches[clause[1]], clause[0], used+2); }// Two watches, the other literal is the blocker
+#endif
   return clause; }                                                 // Return the pointer to the clause is the database
 
 void reduceDB (struct solver* S, int k) {                     // Removes "less useful" lemmas from DB
+  STATS (double start = seconds (); S->stats.reductions++);
   while (S->nLemmas > S->maxLemmas) S->maxLemmas += 300;      // Allow more lemmas in the future
   S->nLemmas = 0;                                             // Reset the number of lemmas
 
   int i; for (i = -S->nVars; i <= S->nVars; i++) {            // Loop over the variables
-    if (i == 0) continue; int* watch = &S->first[i];          // Get the pointer to the first watched clause
+    if (i == 0) continue;
+#ifdef LINKED_WATCHES
+    int* watch = &S->first[i];                                // Get the pointer to the first watched clause
     while (*watch != END)                                     // As long as there are watched clauses
       if (*watch < S->mem_fixed) watch = (S->DB + *watch);    // Remove the watch if it points to a lemma
       else                      *watch =  S->DB[  *watch]; }  // Otherwise (meaning an input clause) go to next watch
+#else
+    removeLemmas (S, &S->watches[i]);                         // Remove the watches of lemmas
+    removeLemmas (S, &S->binaries[i]); }                      // Including binary lemmas
+#endif
 
   int old_used = S->mem_used; S->mem_used = S->mem_fixed;     // Virtually remove all lemmas
   for (i = S->mem_fixed + 2; i < old_used; i += 3) {          // While the old memory contains lemmas
     int count = 0, head = i;                                  // Get the lemma to which the head is pointing
     while (S->DB[i]) { int lit = S->DB[i++];                  // Count the number of literals
       if ((lit > 0) == S->model[abs (lit)]) count++; }        // That are satisfied by the current model
-    if (count < k) addClause (S, S->DB+head, i-head, 0); } }  // If the latter is smaller than k, add it back
+    if (count < k) addClause (S, S->DB+head, i-head, 0); }    // If the latter is smaller than k, add it back
+  if (S->mem_used < S->mem_max / 4) resizeDB (S, S->mem_max / 2); // Give the memory of removed lemmas back
+  STATS (S->stats.reduce += seconds () - start); }
 
 void bump (struct solver* S, int lit) {                       // Move the variable to the front of the decision list
   if (S->false[lit] != IMPLIED) { S->false[lit] = MARK;       // MARK the literal as involved if not a top-level unit
@@ -81,6 +181,7 @@ int implied (struct solver* S, int lit) {                  // Check if lit(eral)
 
 int* analyze (struct solver* S, int* clause) {         // Compute a resolvent from falsified clause
   S->res++; S->nConflicts++;                           // Bump restarts and update the statistic
+  STATS (double start = seconds ());
   while (*clause) bump (S, *(clause++));               // MARK all literals in the falsified clause
   while (S->reason[abs (*(--S->assigned))]) {          // Loop on variables on falseStack until the last decision
     if (S->false[*S->assigned] == MARK) {              // If the tail of the stack is MARK
@@ -100,6 +201,10 @@ int* analyze (struct solver* S, int* clause) {         // Compute a resolvent fr
       if (size == 1) S->processed = p; }               // And update the processed pointer
     S->false[*(p--)] = 1; }                            // Reset the MARK flag for all variables on the stack
 
+  if (S->exportLemma) S->exportLemma (S, S->buffer, size, lbd); // Offer the lemma to other solvers (see portfolio.c)
+  STATS (S->stats.lemmas++; S->stats.size[size < HISTOGRAM ? size : HISTOGRAM - 1]++;
+         S->stats.lbd[lbd < HISTOGRAM ? lbd : HISTOGRAM - 1]++);
+
   S->fast -= S->fast >>  5; S->fast += lbd << 15;      // Update the fast moving average
   S->slow -= S->slow >> 15; S->slow += lbd <<  5;      // Update the slow moving average
 
@@ -107,11 +212,20 @@ int* analyze (struct solver* S, int* clause) {         // Compute a resolvent fr
     unassign (S, *(S->assigned--));                    // Unassign all lits between tail & head
   unassign (S, *S->assigned);                          // Assigned now equal to processed
   S->buffer[size] = 0;                                 // Terminate the buffer (and potentially print clause)
+  STATS (S->stats.analyze += seconds () - start);
   return addClause (S, S->buffer, size, 0); }          // Add new conflict clause to redundant DB
 
+int interrupted (struct solver* S) {                // Is a limit reached: cancellation, propagations or time?
+  S->nextCheck = S->stats.propagations + CHECK;     // Checked every CHECK propagations, and at each propagation
+  if (S->nextCheck > S->maxPropagations) S->nextCheck = S->maxPropagations; // once the budget is used up
+  return (S->cancel && *S->cancel) || S->stats.propagations >= S->maxPropagations ||
+         (S->deadline > 0 && seconds () >= S->deadline); }
+
+#ifdef LINKED_WATCHES
 int propagate (struct solver* S) {                  // Performs unit propagation
   int forced = S->reason[abs (*S->processed)];      // Initialize forced flag
   while (S->processed < S->assigned) {              // While unprocessed false literals
+    if (++S->stats.propagations >= S->nextCheck && !forced && interrupted (S)) return UNKNOWN; // Stop below a decision
     int lit = *(S->processed++);                    // Get first unprocessed literal
     int* watch = &S->first[lit];                    // Obtain the first watch pointer
     while (*watch != END) {                         // While there are watched clauses (watched by lit)
@@ -133,101 +247,279 @@ int propagate (struct solver* S) {                  // Performs unit propagation
         else { if (forced) return UNSAT;            // Found a root level conflict -> UNSAT
           int* lemma = analyze (S, clause);         // Analyze the conflict return a conflict clause
           if (!lemma[1]) forced = 1;                // In case a unit clause is found, set forced flag
-          assign (S, lemma, forced); break; } } } } // Assign the conflict clause as a unit
+          assign (S, lemma, forced);                // Assign the conflict clause as a unit
+          if (!forced && S->nConflicts >= S->maxConflicts) return UNKNOWN; // Stop at the conflict limit
+          break; } } } }
   if (forced) S->forced = S->processed;             // Set S->forced if applicable
   return SAT; }                                     // Finally, no conflict was found
-
-int allVariablesAssigned (struct solver* S) {
-  int nVarsAssigned = 0;
-  for (int i = -S->nVars; i <= S->nVars; i++) {
-    if (S->false[i]) nVarsAssigned++; }
-  return nVarsAssigned == S->nVars; }
-
-int evaluateClauses (struct solver* S) {
-  int clauseStatus = 1;
-  while (S->processed < S->assigned) {
-    int lit = *(S->processed++);
-    int* watch = &S->first[lit];
-    while (*watch != END) {
-      int i, unit = 1;
-      int *clause = (S->DB + *watch + 1);
-      if (clause[-2] == 0) clause++;
-      if (clause[0] == lit) clause[0] = clause[1];
-      for (i = 2; unit && clause[i]; i++)
-        if (!S->false[clause[i]]) {
-          clause[1] = clause[i]; clause[i] = lit;
-          int store = *watch; unit = 0;
-          *watch = S->DB[*watch];
-          addWatch (S, clause[1], store); }
-      if (unit) {
-        clause[1] = lit; watch = (S->DB + *watch);
-        if (S->false[-clause[0]] || !S->false[ clause[0]]) continue;
-        else {
-          clauseStatus = 0;
-          return clauseStatus; } } } }
-  return clauseStatus; }
-
-int evaluateAssignment (struct solver* S) {
-  for (int i = 0; i < S->nAssignments; i++) {
-    if (S->false[S->assignments[i]]) {
-      return 0; }
-    assign (S, &S->assignments[i], 1);
-    if (!evaluateClauses (S)) {
-      return 0; } }
-  return 1; }
+#else
+int propagate (struct solver* S) {                  // Performs unit propagation
+  int forced = S->reason[abs (*S->processed)];      // Initialize forced flag
+  while (S->processed < S->assigned) {              // While unprocessed false literals
+    if (++S->stats.propagations >= S->nextCheck && !forced && interrupted (S)) return UNKNOWN; // Stop below a decision
+    int lit = *(S->processed++), *clause;           // Get first unprocessed literal
+    struct watchList* list = &S->binaries[lit];     // First the binary clauses (lit, other)
+    for (int* w = list->data; w < list->data + list->size; w += 2) {
+      if (S->false[-w[0]]) continue;                // If the other literal is satisfied continue
+      clause = S->DB + w[1];                        // Otherwise the clause is unit or falsified
+      if (!S->false[w[0]]) {                        // A unit clause is found: place the other literal
+        clause[0] = w[0]; clause[1] = lit;          // in front, and set it as the reason
+        assign (S, clause, forced); continue; }
+      goto conflict; }
+    list = &S->watches[lit];                        // Then the longer clauses watched by lit
+    int *w = list->data, *keep = w, *end = w + list->size;
+    while (w < end) {                               // Each watch is a pair (blocker, clause offset)
+      if (S->false[-w[0]]) {                        // If the blocker is satisfied, skip the clause
+        *(keep++) = w[0]; *(keep++) = w[1]; w += 2; continue; }
+      int i, off = w[1]; clause = S->DB + off;      // Get the clause from DB
+      if (clause[0] == lit) clause[0] = clause[1];  // Ensure that the other watched literal is in front
+      clause[1] = lit; w += 2;
+      if (S->false[-clause[0]]) {                   // If the other watched literal is satisfied continue
+        *(keep++) = clause[0]; *(keep++) = off; continue; }
+      for (i = 2; clause[i]; i++)                   // Scan the non-watched literals
+        if (!S->false[clause[i]]) break;            // When clause[i] is not false, it is either true or unset
+      if (clause[i]) {                              // Swap literals and move the watch to clause[1]
+        clause[1] = clause[i]; clause[i] = lit;
+        addWatch (&S->watches[clause[1]], clause[0], off); continue; }
+      *(keep++) = clause[0]; *(keep++) = off;       // The clause is unit or falsified: keep the watch
+      if (!S->false[clause[0]]) {                   // If the other watched literal is not falsified,
+        assign (S, clause, forced); continue; }     // A unit clause is found, and the reason is set
+      while (w < end) *(keep++) = *(w++);           // Keep the remaining watches of lit
+      list->size = keep - list->data;
+      goto conflict; }
+    list->size = keep - list->data;
+    continue;
+
+    conflict: if (forced) return UNSAT;             // Found a root level conflict -> UNSAT
+    int* lemma = analyze (S, clause);               // Analyze the conflict return a conflict clause
+    if (!lemma[1]) forced = 1;                      // In case a unit clause is found, set forced flag
+    assign (S, lemma, forced);                      // Assign the conflict clause as a unit
+    if (!forced && S->nConflicts >= S->maxConflicts) return UNKNOWN; } // Stop at the conflict limit
+  if (forced) S->forced = S->processed;             // Set S->forced if applicable
+  return SAT; }                                     // Finally, no conflict was found
+#endif
 
 int evaluateBuildability (struct solver* S) {
-  if (!allVariablesAssigned (S)) {
-    for (int i = 1; i <= S->nVars; i++) {
-      if (!S->model[i] && !S->false[i]) {
-        int lemma = -i;
-        assign (S, &lemma, 0);
-        if (!evaluateClauses (S)) {
-            return 0; } } } }
-  return 1; }
-
-void evaluateDecisions (struct solver* S) {
-  propagate (S);
-
-  for (int i = S->nAssignments-1; i >= 0; i--) {
-    int* lemma = &S->assignments[i];
-    if ((S->assignments[i] > 0 && !S->model[S->assignments[i]]) || (S->assignments[i] < 0 && !S->false[S->assignments[i]])) {
-      assign (S, lemma, 0);
-      propagate (S); } } }
-
-void printDecisions (struct solver* S) {
-  printf ("v");
+  STATS (double start = seconds ());
+  int result = completionSatisfied (S);
+  STATS (S->stats.buildability += seconds () - start);
+  return result; }
+
+static int reuseLevels (struct solver* S, int* lits, int n) { // Reassign the longest prefix of lits that the previous
+  int i = 0, *end = S->forced;                               // query has propagated: backtrack only unmarks its trail,
+  if (S->assigned != S->forced || S->levelsForced != end - S->falseStack) S->nLevels = 0; // and the watches stay valid
+  while (i < n && i < S->nLevels && S->levels[2*i] == lits[i])                          // for any prefix of the last
+    end = S->falseStack + S->levels[2*i+1], i++;                                        // propagated trail
+  for (int* p = S->forced; p < end; p++) {                   // Query literals have their unit cell as reason, the
+    int var = abs (*p);                                      // other literals are IMPLIED
+    S->false[*p] = (S->reason[var] == 1 + (int) (S->unit + var - S->DB)) ? 1 : IMPLIED; }
+  S->assigned = S->processed = end;
+  S->nLevels = i; S->levelsForced = S->forced - S->falseStack;
+  STATS (S->stats.cacheHits += i; S->stats.cacheMisses += n - i);
+  return i; }
+
+static int propagateDecisions (struct solver* S, int* lits, int n) {
+  if (propagate (S) == UNSAT) return UNSAT;                  // Propagate the top-level units first
+
+  int* forced = S->forced, status = SAT;                     // Queries must not move the top-level forced pointer
+  if (!S->levels) S->levels = allocate (2 * S->nVars + 2);   // Per level the query literal and the end of its trail
+  for (int i = reuseLevels (S, lits, n); i < n; i++) {       // Only the literals after the cached prefix are propagated
+    int lit = lits[i], var = abs (lit);
+    if (S->false[lit]) status = UNSAT;                       // Already false: the assignment is conflicting
+    else if (!S->false[-lit]) {                              // Already true: nothing to propagate
+      S->unit[var] = lit;                                    // The reason of lit is the unit clause (lit)
+      assign (S, &S->unit[var], 0);
+      if (propagate (S) == UNSAT) status = UNSAT; }          // Keep propagating the remaining literals
+    if (status == SAT && S->nLevels == i && i < S->nVars)    // Cache the levels up to the first conflict
+      S->levels[2*i] = lit, S->levels[2*i+1] = S->assigned - S->falseStack, S->nLevels++; }
+  if (S->nEliminated) extendImplied (S);                     // Derive the eliminated variables as well
+  S->forced = forced;
+  return status; }
+
+int evaluateDecisions (struct solver* S, int* lits, int n) {
+  STATS (double start = seconds (); S->stats.queries++);
+  int result = propagateDecisions (S, lits, n);
+  STATS (S->stats.query += seconds () - start);
+  return result; }
+
+int query (struct solver* S, int* lits, int n) {
+  if (evaluateDecisions (S, lits, n) == UNSAT) return INCOMPLETE;
+  return evaluateBuildability (S) ? BUILDABLE : INCOMPLETE; }
+
+void backtrack (struct solver* S) {                          // Lemmas and top-level units are kept
+  restart (S); }
+
+int forcedUnits (struct solver* S, int* out) {               // The true literals of the top level
+  int n = 0;
+  for (int* p = S->falseStack; p < S->forced; p++) out[n++] = -*p;
+  return n; }
+
+int impliedLiterals (struct solver* S, int* out) {
+  int n = 0;
   for (int i = 1; i <= S->nVars; i++) {
     if (S->model[i] && (S->false[-i] == IMPLIED)) {
-      printf (" %i", i); }
+      out[n++] = i; }
       else if (S->false[i] == IMPLIED) {
-      printf (" %i", -i); } }
+      out[n++] = -i; } }
+  return n; }
+
+void printDecisions (struct solver* S) {
+  int n = impliedLiterals (S, S->buffer);
+  printf ("v");
+  for (int i = 0; i < n; i++) {
+    printf (" %i", S->buffer[i]); }
   printf ("\n"); }
 
-int solve (struct solver* S) {                                      // Determine satisfiability
+#ifndef NO_STATS
+static void printHistogram (FILE* out, char* name, long* counts, int json) { // Buckets 1, 2, ..., HISTOGRAM-1 or more
+  fprintf (out, json ? "\"%s\": [" : "c %s:", name);
+  for (int i = 1; i < HISTOGRAM; i++)
+    if (json) fprintf (out, i > 1 ? ", %li" : "%li", counts[i]);
+    else      fprintf (out, " %i%s:%li", i, i < HISTOGRAM - 1 ? "" : "+", counts[i]);
+  fprintf (out, json ? "]" : "\n"); }
+#endif
+
+void printStatistics (struct solver* S, FILE* out, int json) {  // Print the statistics as "c" lines or as JSON
+#ifdef NO_STATS
+  fprintf (out, json ? "{}\n" : "c no statistics (built with -DNO_STATS)\n");
+#else
+  struct statistics* T = &S->stats; double solve = T->solve > 0 ? T->solve : 1e-9;
+  if (json) {
+    fprintf (out, "{\"conflicts\": %i, \"decisions\": %li, \"propagations\": %li, \"restarts\": %li, "
+      "\"reductions\": %li, \"queries\": %li, \"lemmas\": %li, ", S->nConflicts, T->decisions, T->propagations,
+      T->restarts, T->reductions, T->queries, T->lemmas);
+    fprintf (out, "\"cache\": {\"hits\": %li, \"misses\": %li}, ", T->cacheHits, T->cacheMisses);
+    printHistogram (out, "size", T->size, 1); fprintf (out, ", "); printHistogram (out, "lbd", T->lbd, 1);
+    fprintf (out, ", \"arena\": {\"used\": %li, \"peak\": %li, \"allocated\": %li}, ",
+      4L * S->mem_used, 4L * S->mem_peak, 4L * S->mem_max);
+    fprintf (out, "\"time\": {\"parse\": %.6f, \"preprocess\": %.6f, \"solve\": %.6f, \"analyze\": %.6f, "
+      "\"reduce\": %.6f, \"query\": %.6f, \"buildability\": %.6f}}\n", T->parse, T->preprocess, T->solve,
+      T->analyze, T->reduce, T->query, T->buildability); }
+  else {
+    fprintf (out, "c %i conflicts (%.0f/s), %li decisions, %li propagations (%.0f/s), %li restarts, %li reductions\n",
+      S->nConflicts, S->nConflicts / solve, T->decisions, T->propagations, T->propagations / solve, T->restarts,
+      T->reductions);
+    fprintf (out, "c %li lemmas, %li queries, %li cache hits, %li cache misses (decision levels)\n", T->lemmas,
+      T->queries, T->cacheHits, T->cacheMisses);
+    printHistogram (out, "lemma size", T->size, 0); printHistogram (out, "lemma LBD", T->lbd, 0);
+    fprintf (out, "c arena: %.1f MB used, %.1f MB peak, %.1f MB allocated\n",
+      S->mem_used * 4e-6, S->mem_peak * 4e-6, S->mem_max * 4e-6);
+    fprintf (out, "c time: %.3f s parse, %.3f s preprocess, %.3f s solve (%.3f s analyze, %.3f s reduce), "
+      "%.3f s query (%.3f s buildability)\n", T->parse, T->preprocess, T->solve, T->analyze, T->reduce,
+      T->query + T->buildability, T->buildability); }
+#endif
+  fflush (out); }
+
+static int search (struct solver* S) {                              // Determine satisfiability
   int decision = S->head;                                           // Initialize the solver
   for (;;) {                                                        // Main solve loop
     int old_nLemmas = S->nLemmas;                                   // Store nLemmas to see whether propagate adds lemmas
-    if (propagate (S) == UNSAT) return UNSAT;                       // Propagation returns UNSAT for a root level conflict
+    int status = propagate (S);                                     // Propagation returns UNSAT for a root level conflict
+    if (status == UNSAT) return UNSAT;
+    if (status == UNKNOWN) { restart (S); return UNKNOWN; }         // and UNKNOWN when a limit is reached
 
     if (S->nLemmas > old_nLemmas) {                                 // If the last decision caused a conflict
       decision = S->head;                                           // Reset the decision heuristic to head
-      if (S->fast > (S->slow / 100) * 125) {                        // If fast average is substantially larger than slow average
-        S->res = 0; S->fast = (S->slow / 100) * 125; restart (S);   // Restart and update the averages
-        if (S->nLemmas > S->maxLemmas) reduceDB (S, 6); } }         // Reduce the DB when it contains too many lemmas
+      if (S->fast > (S->slow / 100) * S->restartMargin) {           // If fast average is substantially larger than slow average
+        S->res = 0; S->fast = (S->slow / 100) * S->restartMargin;   // Restart and update the averages
+        STATS (S->stats.restarts++);
+        restart (S);
+        if (S->nLemmas > S->maxLemmas) reduceDB (S, S->reduceK); }  // Reduce the DB when it contains too many lemmas
+      if (S->nConflicts >= S->maxConflicts) {                       // Stop when the conflict limit is reached, at the
+        restart (S); return UNKNOWN; } }                            // top level so that solve can be called again
+
+    int i, lit = 0;                                                 // Assumptions are decided before any other variable
+    for (i = 0; i < S->nAssumptions && !lit; i++) {                 // Find the first assumption that is not yet true
+      if (S->false[S->assumptions[i]]) return UNSAT;                // A falsified assumption means UNSAT under the assumptions
+      if (!S->false[-S->assumptions[i]]) lit = S->assumptions[i]; }
+    if (lit) {                                                      // Decide the unassigned assumption
+      S->false[-lit] = 1; *(S->assigned++) = -lit; S->reason[abs (lit)] = 0;
+      S->model[abs (lit)] = lit > 0;                                // Like assign, so that a model satisfies the assumptions
+      STATS (S->stats.decisions++); continue; }
 
     while (S->false[decision] || S->false[-decision]) {             // As long as the temporary decision is assigned
       decision = S->prev[decision]; }                               // Replace it with the next variable in the decision list
-    if (decision == 0) return SAT;                                  // If the end of the list is reached, then a solution is found
+    if (decision == 0) {                                            // If the end of the list is reached, then a solution is found
+      if (S->nEliminated) extendModel (S);                          // (including the variables removed by preprocess)
+      return SAT; }
     decision = S->model[decision] ? decision : -decision;           // Otherwise, assign the decision variable based on the model
     S->false[-decision] = 1;                                        // Assign the decision literal to true (change to IMPLIED-1?)
     *(S->assigned++) = -decision;                                   // And push it on the assigned stack
-    decision = abs(decision); S->reason[decision] = 0; } }          // Decisions have no reason clauses
+    decision = abs(decision); S->reason[decision] = 0;              // Decisions have no reason clauses
+    STATS (S->stats.decisions++); } }
+
+int solve (struct solver* S) {
+  STATS (double start = seconds ());
+  S->nLevels = 0;                                                   // Search moves the watches: drop the cached levels
+  int result = search (S);
+  STATS (S->stats.solve += seconds () - start);
+  return result; }
+
+int solveAssuming (struct solver* S, int* lits, int n) {            // Solve under assumptions (lits) incrementally
+  S->assumptions = lits; S->nAssumptions = n;                       // The assumptions are decided first by solve
+  int result = solve (S);                                           // Learned lemmas stay in the DB for later calls
+  S->assumptions = 0; S->nAssumptions = 0;
+  backtrack (S);                                                    // Roll back to the top-level units (S->model is kept)
+  return result; }
 
 void initDatabase (struct solver* S) {
   S->mem_used       = 0;                              // The number of integers allocated in the DB
-  S->DB = (int *) malloc (sizeof (int) * MEM_MAX);    // Allocate the initial database
-  S->DB[S->mem_used++] = 0; }                         // Make sure there is a 0 before the clauses are loaded
+  S->mem_max        = 0;                              // The size of the DB, which grows on demand
+  S->mem_peak       = 0;                              // The maximal number of integers allocated in the DB
+  S->DB = S->unit   = NULL;                           // The DB is allocated once the header is known
+  S->nAssignments   = 0;                              // No assignment unless a "c v" line is parsed
+  S->assignments    = NULL;                           // (the array grows with its literals, see readHeader)
+  S->nAssumptions   = 0;                              // No assumptions unless solveAssuming is used
+  S->nEliminated    = 0;                              // No eliminated variables unless preprocess is used
+  S->nLevels        = 0;                              // No cached query levels yet (see reuseLevels)
+  S->levelsForced   = 0;                              // The top level of the cached levels
+  S->levels         = NULL;                           // Allocated by the first query
+  S->completion     = NULL;                           // The buildability counters are built by the first check
+  S->exportLemma    = NULL;                           // Lemmas are only shared by the portfolio
+  memset (&S->stats, 0, sizeof (S->stats)); }         // No statistics yet
+
+void freeSolver (struct solver* S) {
+  freeCompletion (S);
+  if (S->nAssignments) free (S->assignments);
+  if (S->nEliminated) free (S->eliminated);
+  free (S->model); free (S->next); free (S->prev); free (S->buffer); free (S->reason); free (S->falseStack);
+  free (S->levels);
+  free (S->false - S->nVars); free (S->DB);
+#ifdef LINKED_WATCHES
+  free (S->first - S->nVars); }
+#else
+  for (int i = -S->nVars; i <= S->nVars; i++) free (S->watches[i].data), free (S->binaries[i].data);
+  free (S->watches - S->nVars); free (S->binaries - S->nVars); }
+#endif
+
+int* duplicate (int* array, int size) {                   // Copy an array outside of the DB
+  int* copy = allocate (size); memcpy (copy, array, sizeof (int) * size);
+  return copy; }
+
+void copySolver (struct solver* T, struct solver* S) {    // Make T an independent copy of the loaded solver S
+  int n = S->nVars;
+  *T = *S;                                                // Copy the scalars, then the arrays
+  T->DB = NULL; T->unit = NULL; resizeDB (T, S->mem_max);
+  memcpy (T->DB, S->DB, sizeof (int) * S->mem_used); T->unit = T->DB + (S->unit - S->DB);
+  T->model  = duplicate (S->model, n+1);  T->next   = duplicate (S->next, n+1);
+  T->prev   = duplicate (S->prev, n+1);   T->buffer = duplicate (S->buffer, n);
+  T->reason = duplicate (S->reason, n+1); T->falseStack = duplicate (S->falseStack, n+1);
+  T->forced    = T->falseStack + (S->forced    - S->falseStack);
+  T->processed = T->falseStack + (S->processed - S->falseStack);
+  T->assigned  = T->falseStack + (S->assigned  - S->falseStack);
+  T->false = duplicate (S->false - n, 2*n+1) + n;
+#ifdef LINKED_WATCHES
+  T->first = duplicate (S->first - n, 2*n+1) + n;
+#else
+  T->watches = allocateLists (n); T->binaries = allocateLists (n);
+  for (int i = -n; i <= n; i++) {                        // Copy the lists at their current size
+    copyList (&T->watches[i], &S->watches[i]); copyList (&T->binaries[i], &S->binaries[i]); }
+#endif
+  if (S->nEliminated) T->eliminated = duplicate (S->eliminated, S->nEliminated);
+  T->completion = NULL;                                   // T builds its own buildability counters
+  T->levels = NULL; T->nLevels = 0;                       // and its own cache of query levels
+  T->nAssignments = 0; T->assignments = NULL;             // The query and the assumptions stay with S
+  T->nAssumptions = 0; T->assumptions = NULL; }
 
 void initCDCL (struct solver* S, int n, int m) {
   if (n < 1)      n = 1;                  // The code assumes that there is at least one variable
@@ -238,74 +530,147 @@ void initCDCL (struct solver* S, int n, int m) {
   S->maxLemmas      = 2000;               // Initial maximum number of learnt clauses
   S->res = 0;                             // Initialize restarts
   S->fast = S->slow = 1 << 24;            // Initialize the fast and slow moving averages
-
-  S->model       = getMemory (S, n+1); // Full assignment of the (Boolean) variables (initially set to false)
-  S->next        = getMemory (S, n+1); // Next variable in the heuristic order
-  S->prev        = getMemory (S, n+1); // Previous variable in the heuristic order
-  S->buffer      = getMemory (S, n  ); // A buffer to store a temporary clause
-  S->reason      = getMemory (S, n+1); // Array of clauses
-  S->falseStack  = getMemory (S, n+1); // Stack of falsified literals -- this pointer is never changed
+  S->restartMargin  = 125;                // Restart if the fast average exceeds the slow one by 25 percent
+  S->reduceK        = 6;                  // Keep lemmas with less than 6 satisfied literals in reduceDB
+  S->maxConflicts   = INT_MAX;            // Solve without limit (number of conflicts)
+  S->maxPropagations = LONG_MAX;          // Nor a limit of propagations
+  S->nextCheck      = CHECK;              // The number of propagations at which the limits are checked next
+  S->deadline       = 0;                  // Nor a deadline (in seconds, see seconds ())
+  S->cancel         = NULL;               // Nor a cancellation flag (stop solving once *cancel is set)
+
+  long size = (n + 2) + 6L * m;                          // Initial size of the DB: n+1 unit clauses, the clauses
+  resizeDB (S, size < MEM_MAX ? size : MEM_MAX);         // (three literals on average) and a sentinel
+
+  S->model       = allocate (n+1);     // Full assignment of the (Boolean) variables (initially set to false)
+  S->next        = allocate (n+1);     // Next variable in the heuristic order
+  S->prev        = allocate (n+1);     // Previous variable in the heuristic order
+  S->buffer      = allocate (n  );     // A buffer to store a temporary clause
+  S->reason      = allocate (n+1);     // Array of clauses
+  S->falseStack  = allocate (n+1);     // Stack of falsified literals -- this pointer is never changed
   S->forced      = S->falseStack;      // Points inside *falseStack at first decision (unforced literal)
   S->processed   = S->falseStack;      // Points inside *falseStack at first unprocessed literal
   S->assigned    = S->falseStack;      // Points inside *falseStack at last unprocessed literal
-  S->false       = getMemory (S, 2*n+1); S->false += n; // Labels for variables, non-zero means false
-  S->first       = getMemory (S, 2*n+1); S->first += n; // Offset of the first watched clause
+  S->false       = allocate (2*n+1); S->false += n; // Labels for variables, non-zero means false
+#ifdef LINKED_WATCHES
+  S->first       = allocate (2*n+1); S->first += n; // Offset of the first watched clause
+#else
+  S->watches     = allocateLists (n);  // Watches (blocker, clause) of clauses with more than two literals
+  S->binaries    = allocateLists (n);  // Implications (other literal, clause) of binary clauses
+#endif
+  S->unit        = getMemory (S, n+1); // Unit clauses that serve as reasons for assigned literals of a query (in the DB)
 
   int i; for (i = 1; i <= n; i++) {                        // Initialize the main data structures:
     S->prev [i] = i - 1; S->next[i-1] = i;                 // the double-linked list for variable-move-to-front,
-    S->model[i] = S->false[-i] = S->false[i] = 0;          // the model (phase-saving), the false array,
-    S->first[i] = S->first[-i] = END; }                    // and first (watch pointers).
-  S->head = n; }                                           // Initialize the head of the double-linked list
-
-int parse (struct solver* S, char* filename) {                            // Parse the formula and initialize
-  int tmp; FILE* input = fopen (filename, "r");                           // Read the CNF file
-  if (input == NULL) printf ("c FILE NOT FOUND\n"), exit (ERROR);         // Exit if file not found
+    S->model[i] = S->false[-i] = S->false[i] = 0; }        // the model (phase-saving), the false array,
+#ifdef LINKED_WATCHES
+  for (i = 1; i <= n; i++)
+    S->first[i] = S->first[-i] = END;                      // and first (watch pointers).
+#endif
+  S->head = n;                                             // Initialize the head of the double-linked list
+  S->DB[S->mem_used++] = 0;                                // Make sure there is a 0 before the clauses are loaded
+  S->mem_clauses = S->mem_fixed = S->mem_used; }          // The clauses start here; none yet (a formula may have none)
+
+struct reader {                                                           // Input of the parser: a memory-mapped file
+  char *pos, *end, *map; size_t size; FILE* file; pid_t pid;               // or a buffered stream (pipes, compressed files)
+  char buffer[1 << 16]; };
+
+FILE* decompress (struct reader* R, char* tool, char* filename) {         // Read the output of "tool -dc filename"
+  int fd[2]; if (pipe (fd)) return NULL;
+  if (!(R->pid = fork ())) {
+    dup2 (fd[1], 1); close (fd[0]); close (fd[1]);
+    execlp (tool, tool, "-dc", filename, (char*) NULL); _exit (ERROR); }
+  close (fd[1]); return fdopen (fd[0], "r"); }
+
+int openReader (struct reader* R, char* filename) {                       // Returns 0 if the file cannot be opened
+  char* suffix = strrchr (filename, '.'); struct stat info; int fd;
+  R->map = NULL; R->file = NULL; R->pid = 0; R->pos = R->end = R->buffer;
+  if      (suffix && !strcmp (suffix, ".gz"))  R->file = decompress (R, "gzip", filename);
+  else if (suffix && !strcmp (suffix, ".xz"))  R->file = decompress (R, "xz", filename);
+  else if (!strcmp (filename, "-"))            R->file = stdin;
+  else if ((fd = open (filename, O_RDONLY)) < 0) return 0;
+  else {
+    if (!fstat (fd, &info) && S_ISREG (info.st_mode) && info.st_size > 0) {           // Map regular files,
+      R->size = info.st_size;
+      R->map = mmap (NULL, R->size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (R->map == MAP_FAILED) R->map = NULL;
+      else madvise (R->map, R->size, MADV_SEQUENTIAL), R->pos = R->map, R->end = R->map + R->size; }
+    if (R->map) close (fd); else R->file = fdopen (fd, "r"); }                      // stream anything else
+  return R->map || R->file; }
+
+void closeReader (struct reader* R) {
+  if (R->map) munmap (R->map, R->size);
+  if (R->file && R->file != stdin) fclose (R->file);
+  if (R->pid > 0) waitpid (R->pid, NULL, 0); }
+
+static inline int peek (struct reader* R) {                               // The next character without consuming it
+  if (R->pos == R->end) {                                                 // Refill the buffer of a stream
+    size_t n = R->file ? fread (R->buffer, 1, sizeof (R->buffer), R->file) : 0;
+    if (!n) return EOF;
+    R->pos = R->buffer; R->end = R->buffer + n; }
+  return *R->pos; }
+
+void skipLine (struct reader* R) {
+  int c; while ((c = peek (R)) != EOF && c != '\n') R->pos++; }
+
+int readInt (struct reader* R, int* value) {                              // Decode a (signed) integer; returns 0 if
+  int c, sign = 1, n = 0;                                                 // there is no integer before the end of line
+  while ((c = peek (R)) == ' ' || c == '\t' || c == '\r') R->pos++;       // Skip white space
+  if (c == '-') sign = -1, c = (++R->pos, peek (R));
+  if (c < '0' || c > '9') return 0;
+  do { n = n * 10 + (c - '0'); R->pos++; } while ((c = peek (R)) >= '0' && c <= '9');
+  *value = sign * n; return 1; }
+
+int readHeader (struct solver* S, struct reader* R, int mode) {           // Skip comments until the "p cnf" line and
+  int c;                                                                  // collect the "c v" line in MODE_PROPAGATE
+  while ((c = peek (R)) != EOF) {
+    if (c == 'p') {
+      for (char* p = "p cnf"; *p && peek (R) == *p; p++) R->pos++;
+      if (!readInt (R, &S->nVars) || !readInt (R, &S->nClauses) || S->nAssignments > S->nVars) return 0;
+      for (int i = 0; i < S->nAssignments; i++)                           // Check the assignment like the queries
+        if (!S->assignments[i] || abs (S->assignments[i]) > S->nVars) return 0; // of readAssignment (main.c)
+      return 1; }
+    if (c == 'c' && mode == MODE_PROPAGATE && !S->nAssignments) {         // Parse the assigned variables
+      R->pos++; int n, lit, capacity = 0;                                 // The array grows with the literals read,
+      if (peek (R) == ' ' && (++R->pos, peek (R)) == 'v' && (++R->pos, readInt (R, &n))) { // not with the count
+        if (n < 0) return 0;
+        while (S->nAssignments < n && readInt (R, &lit)) {
+          if (S->nAssignments == capacity) {
+            capacity = 2 * capacity + 16; S->assignments = reallocate (S->assignments, sizeof (int) * capacity); }
+          S->assignments[S->nAssignments++] = lit; }
+        if (S->nAssignments < n) return 0; } }                            // Fewer literals than announced
+    skipLine (R); if (peek (R) != EOF) R->pos++; }                        // Skip the rest of the line
+  return 0; }
+
+int parse (struct solver* S, char* filename, int mode) {                  // Parse the formula and initialize
+  STATS (double start = seconds ());
+  struct reader* R = zeroed (1, sizeof (struct reader));                  // Read the CNF file in a single pass
+  if (!openReader (R, filename)) printf ("c FILE NOT FOUND\n"), exit (ERROR); // Exit if file not found
 
   initDatabase(S);
-
-  if (MODE == MODE_PROPAGATE) {                                           // Parse the additional comment lines
-    int i;
-    do { tmp = fscanf (input, " c v%i", &S->nAssignments);                // Parse assigned variables
-      if (tmp > 0 && tmp != EOF) break; tmp = fscanf (input, "%*s\n"); }  // Skip rest of line
-    while (tmp != 1 && tmp != EOF);
-    S->assignments = getMemory (S, S->nAssignments);
-    i = 0;
-    while (i < S->nAssignments) {
-      fscanf (input, "%i", &S->assignments[i++]); }
-    fseek (input, 0, SEEK_SET);                                           // Reset file position
-  }
-
-  do { tmp = fscanf (input, " p cnf %i %i \n", &S->nVars, &S->nClauses);  // Find the first non-comment line
-    if (tmp > 0 && tmp != EOF) break; tmp = fscanf (input, "%*s\n"); }    // In case a comment line was found
-  while (tmp != 2 && tmp != EOF);                                         // Skip it and read next line
+  if (!readHeader (S, R, mode)) printf ("c PARSE ERROR\n"), exit (ERROR); // Find the first non-comment line
 
   initCDCL (S, S->nVars, S->nClauses);                     // Allocate the main datastructures
-  int nZeros = S->nClauses, size = 0;                      // Initialize the number of clauses to read
-  while (nZeros > 0) {                                     // While there are clauses in the file
-    int lit = 0; tmp = fscanf (input, " %i ", &lit);       // Read a literal.
+  int nZeros = S->nClauses, size = 0, result = SAT, c;     // Initialize the number of clauses to read
+  int from = S->mem_used;                                  // The clauses are watched once all are read
+  int *seen = allocate (2*S->nVars+1) + S->nVars, tautology = 0; // The literals in the buffer: at most nVars
+  while (nZeros > 0 && (c = peek (R)) != EOF) {            // While there are clauses in the file
+    int lit;
+    if (c == ' ' || c == '\n' || c == '\t' || c == '\r') { R->pos++; continue; }  // Skip white space
+    if (c == 'c') { skipLine (R); continue; }              // And comment lines
+    if (!readInt (R, &lit) || abs (lit) > S->nVars) printf ("c PARSE ERROR\n"), exit (ERROR);
     if (!lit) {                                            // If reaching the end of the clause
-      int* clause = addClause (S, S->buffer, size, 1);     // Then add the clause to data_base
-      if (!size || ((size == 1) && S->false[clause[0]]))   // Check for empty clause or conflicting unit
-        return UNSAT;                                      // If either is found return UNSAT
+      for (int i = 0; i < size; i++) seen[S->buffer[i]] = 0;
+      if (tautology) { size = tautology = 0; --nZeros; continue; } // Skip a clause with lit and -lit (always true)
+      int* clause = storeClause (S, S->buffer, size, 1);   // Then add the clause to data_base
+      if (!size || ((size == 1) && S->false[clause[0]])) { // Check for empty clause or conflicting unit
+        result = UNSAT; break; }                           // If either is found return UNSAT
       if ((size == 1) && !S->false[-clause[0]]) {          // Check for a new unit
         assign (S, clause, 1); }                           // Directly assign new units (forced = 1)
       size = 0; --nZeros; }                                // Reset buffer
-    else S->buffer[size++] = lit; }                        // Add literal to buffer
-  fclose (input);                                          // Close the formula file
-  return SAT; }                                            // Return that no conflict was observed
-
-int main (int argc, char** argv) {                                                                          // The main procedure
-  if (argc == 1) printf ("Usage: microsat [--version] [--propagate] DIMACS_FILE\n"), exit (OK);             // Print usage if no argument is given
-  if (!strcmp (argv[1], "--version")) printf (VERSION "\n"), exit (OK);                                     // Print version if argument --version is given
-  else if (!strcmp (argv[1], "--propagate")) MODE = MODE_PROPAGATE, ++argv;                                 // Set mode to propagate an assignment
-
-  struct solver S;                                                                        // Create the solver datastructure
-  if (parse (&S, argv[1]) == UNSAT) printf("s UNSATISFIABLE\n"), exit (UNSAT);            // Parse the DIMACS file
-
-  if (MODE == MODE_SOLVE) {
-    if (solve (&S) == UNSAT) printf("s UNSATISFIABLE\n"), exit (UNSAT);                   // Solve without limit (number of conflicts)
-    else printf("s SATISFIABLE\n"), exit (SAT); }                                         // and print whether the formula has a solution
-  else if (MODE == MODE_PROPAGATE) {
-    evaluateDecisions (&S), printDecisions (&S);
-    if (evaluateBuildability(&S)) printf ("s BUILDABLE\n"), exit (BUILDABLE);
-    else printf ("s INCOMPLETE\n"), exit (INCOMPLETE); } }
\ No newline at end of file
+    else if (seen[-lit]) tautology = 1;
+    else if (!seen[lit]) seen[lit] = 1, S->buffer[size++] = lit; } // Add literal to buffer (once)
+  free (seen - S->nVars);
+  watchClauses (S, from);                                  // Watch all clauses in one go
+  closeReader (R); free (R);                               // Close the formula file
+  STATS (S->stats.parse = seconds () - start);
+  return result; }                                         // Return whether a conflict was observed
@@ -0,0 +1,86 @@
+#ifndef MICROSAT_H
+#define MICROSAT_H
+
+#include <stdio.h>
+
+enum EXIT_CODES { OK = 0, ERROR = 1, SAT = 10, UNSAT = 20, BUILDABLE = 30, INCOMPLETE = 40, UNKNOWN = 50 };
+enum LITERAL_MARKS { END = -9, MARK = 2, IMPLIED = 6 };
+enum MODES { MODE_SOLVE = 0, MODE_PROPAGATE = 1 };
+enum HISTOGRAMS { HISTOGRAM = 16 };                    // Buckets of the lemma histograms; the last one counts the rest
+
+#ifdef NO_STATS                                        // Build with -DNO_STATS to compile the statistics out
+#define STATS(code)
+#else
+#define STATS(code) code
+#endif
+
+struct watchList { int size, capacity, *data; };       // Pairs of a blocker literal and a clause offset in the DB
+struct list { int size, capacity, *data; };            // A growing array of integers (see push)
+
+struct completion;                                     // The buildability counters (see buildability.c)
+
+struct statistics {                                    // Counters and times (in seconds); zero in a NO_STATS build,
+                                                       // except the propagations, which the limits need
+  long propagations, decisions, restarts, reductions, queries, lemmas, size[HISTOGRAM], lbd[HISTOGRAM];
+  long cacheHits, cacheMisses;                         // Query literals whose level was reused or propagated
+  double parse, preprocess, solve, analyze, reduce, query, buildability; };
+
+struct solver { // The variables in the struct are described in the allocate procedure
+  int  *DB, nVars, nClauses, mem_used, mem_clauses, mem_fixed, mem_max, mem_peak, maxLemmas, nLemmas, *buffer, nConflicts, *model,
+       *reason, *falseStack, *false, *first, *forced, *processed, *assigned, *next, *prev, head, res, fast, slow,
+       nAssignments, *assignments, *unit, nAssumptions, *assumptions, restartMargin, reduceK, maxConflicts,
+       nEliminated, *eliminated, nLevels, *levels, levelsForced;
+  long maxPropagations, nextCheck;
+  double deadline;
+  volatile int* cancel;
+  struct watchList *watches, *binaries;
+  struct statistics stats;
+  struct completion* completion;
+  void (*exportLemma) (struct solver* S, int* lemma, int size, int lbd); };
+
+int  parse                (struct solver* S, char* filename, int mode); // Load a DIMACS file (and its "c v" line in MODE_PROPAGATE)
+void freeSolver           (struct solver* S);                           // Release the memory of a loaded solver
+void copySolver           (struct solver* T, struct solver* S);         // Make T an independent copy of S
+int  preprocess           (struct solver* S, int* frozen, int nFrozen, int full); // Simplify the clauses after parse:
+                                                                        // full = 0 keeps the answers of queries, full = 1
+                                                                        // also strengthens and eliminates (for solve, where
+                                                                        // only frozen variables may be assumed)
+
+void assign               (struct solver* S, int* reason, int forced);  // Make reason[0] true (IMPLIED if forced)
+void restart              (struct solver* S);                           // Unassign all literals above S->forced
+int  propagate            (struct solver* S);                           // Unit propagation: SAT, UNSAT (top-level conflict)
+                                                                        // or UNKNOWN (a limit is reached below a decision)
+int  interrupted          (struct solver* S);                           // Is S->cancel set or a limit of propagations or time reached?
+int* addClause            (struct solver* S, int* in, int size, int irr); // Add (and watch) a clause or a lemma
+int* storeClause          (struct solver* S, int* in, int size, int irr); // Add a clause without watching it
+void watchClauses         (struct solver* S, int from);                 // Watch the clauses stored after offset from
+void extendModel          (struct solver* S);                           // Set the eliminated variables in S->model
+void extendImplied        (struct solver* S);                           // Assign the eliminated variables implied by the trail
+int  eliminatedSatisfied  (struct solver* S);                           // Do the clauses of eliminated variables hold?
+int  completionSatisfied  (struct solver* S);                           // Does the completion undecided = false satisfy all clauses?
+void freeCompletion       (struct solver* S);                           // Release the buildability counters
+
+int  solve                (struct solver* S);                           // Determine satisfiability: SAT, UNSAT or UNKNOWN (see the
+                                                                        // limits maxConflicts, maxPropagations, deadline and cancel)
+int  solveAssuming        (struct solver* S, int* lits, int n);         // Determine satisfiability under assumptions, keeps lemmas
+int  solvePortfolio       (struct solver* S, int nThreads, int seed);   // Solve with nThreads diversified copies of S
+int  evaluateDecisions    (struct solver* S, int* lits, int n);         // Propagate a (partial) assignment: SAT or UNSAT (conflict)
+int  evaluateBuildability (struct solver* S);                           // Check the completion undecided = false: 1 or 0
+int  query                (struct solver* S, int* lits, int n);         // Both of the above: BUILDABLE or INCOMPLETE
+int  impliedLiterals      (struct solver* S, int* out);                 // Store the implied literals in out, return their number
+int  forcedUnits          (struct solver* S, int* out);                 // Store the top-level units in out, return their number
+int  unsatisfiedClauses   (struct solver* S, int** clauses, int** variables); // After an INCOMPLETE query: the clauses that
+                                                                        // the completion falsifies (each ends with 0) and
+                                                                        // their undecided variables (ends with 0), returns
+                                                                        // the number of clauses; valid until the next call
+void printDecisions       (struct solver* S);                           // Print the implied literals as "v" line
+void backtrack            (struct solver* S);                           // Undo a query, i.e., roll the trail back to S->forced
+void printStatistics      (struct solver* S, FILE* out, int json);      // Print S->stats as "c" lines or as JSON
+double seconds            (void);                                       // Monotonic time in seconds
+
+int* allocate             (int size);                                   // Memory outside of the DB: zeroed integers,
+void* zeroed              (size_t count, size_t size);                  // zeroed items or a resized array; these exit
+void* reallocate          (void* array, size_t size);                   // with "c OUT OF MEMORY" instead of returning NULL
+void push                 (struct list* list, int value);               // Append value, doubling the capacity if needed
+
+#endif
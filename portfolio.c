@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "microsat.h"
+
+enum PORTFOLIO { PERIOD = 4096, SHARE_SIZE = 8, SHARE_LBD = 2, SLOT = 32 }; // Conflicts between two exchanges, which
+                                                                            // lemmas are shared, and their maximal size
+struct thread {                      // A solver of the portfolio; S must be the first member (see exportLemma)
+  struct solver S;
+  int id, result, stopped, nExported, *exported; // Lemmas exported in the current period: slots of [size, literals]
+  struct portfolio* P; };
+
+struct portfolio {
+  int nThreads, maxConflicts; struct thread* threads; pthread_barrier_t barrier; }; // The limit of S per thread
+
+unsigned nextRandom (unsigned* state) {                                     // Xorshift random numbers
+  *state ^= *state << 13; *state ^= *state >> 17; *state ^= *state << 5;
+  return *state; }
+
+void exportLemma (struct solver* S, int* lemma, int size, int lbd) {        // Called by analyze for every lemma
+  struct thread* T = (struct thread*) S;
+  if (size > SLOT - 1 || (size > SHARE_SIZE && lbd > SHARE_LBD)) return;   // Share short or low LBD lemmas only
+  if (T->nExported == PERIOD) return;                                      // The buffer holds one lemma per conflict
+  int* slot = T->exported + SLOT * T->nExported++;
+  slot[0] = size; for (int i = 0; i < size; i++) slot[i+1] = lemma[i]; }
+
+int importLemma (struct solver* S, int* lemma, int size) {                  // Add a lemma of another thread at the top
+  int i, n = 0;                                                            // level; returns UNSAT for an empty lemma
+  for (i = 0; i < size; i++) {
+    if (S->false[-lemma[i]]) return SAT;                                   // Skip lemmas that are already satisfied
+    if (!S->false[lemma[i]]) S->buffer[n++] = lemma[i]; }                  // And remove falsified literals
+  if (!n) return UNSAT;
+  S->buffer[n] = 0; int* clause = addClause (S, S->buffer, n, 0);
+  if (n == 1) assign (S, clause, 1);                                       // Assign new units (forced = 1)
+  return SAT; }
+
+void* work (void* data) {                                                   // The solve loop of a thread: all threads
+  struct thread* T = data; struct portfolio* P = T->P;                     // meet after every period, so the lemmas
+  struct solver* S = &T->S;                                                // exchanged (and the result) do not depend
+  int i, j, failed = 0;                                                    // on timing
+  for (;;) {
+    T->nExported = 0;
+    if (failed) T->result = UNSAT;                                         // An imported lemma was empty
+    else {
+      S->maxConflicts = S->nConflicts + PERIOD;                            // Stop at the end of the period, or earlier
+      if (S->maxConflicts > P->maxConflicts) S->maxConflicts = P->maxConflicts; // at the limits of S
+      T->result = solve (S);
+      T->stopped = T->result == UNKNOWN && (S->nConflicts >= P->maxConflicts || interrupted (S)); }
+    pthread_barrier_wait (&P->barrier);                                    // All lemmas of this period are exported
+    for (i = 0; i < P->nThreads; i++)
+      if (P->threads[i].result != UNKNOWN || P->threads[i].stopped) return NULL; // Some thread finished or stopped
+    for (i = 0; i < P->nThreads; i++) {                                    // Import the lemmas of the other threads
+      struct thread* U = &P->threads[i]; if (U == T) continue;
+      for (j = 0; j < U->nExported; j++)
+        failed |= importLemma (S, U->exported + SLOT * j + 1, U->exported[SLOT * j]) == UNSAT; }
+    pthread_barrier_wait (&P->barrier); } }                                // All lemmas are imported
+
+int solvePortfolio (struct solver* S, int nThreads, int seed) {
+  struct portfolio P = { .nThreads = nThreads, .maxConflicts = S->maxConflicts };
+  P.threads = zeroed (nThreads, sizeof (struct thread));
+  pthread_barrier_init (&P.barrier, NULL, nThreads);
+  int i, result = UNKNOWN, maxConflicts = S->maxConflicts; unsigned state = 2463534242u ^ (unsigned) seed;
+  for (i = 0; i < nThreads; i++) {                                         // Diversify the copies of S: thread 0 keeps
+    struct thread* T = &P.threads[i];                                      // the defaults, the others get random
+    if (i) copySolver (&T->S, S); else T->S = *S;                          // phases, restart margins and reduceDB k
+    T->id = i; T->P = &P; T->result = UNKNOWN;
+    T->exported = allocate (SLOT * PERIOD);
+    T->S.exportLemma = (nThreads > 1) ? exportLemma : NULL;
+    if (!i) continue;
+    for (int v = 1; v <= S->nVars; v++) T->S.model[v] = nextRandom (&state) & 1;
+    T->S.restartMargin = 110 + nextRandom (&state) % 41;
+    T->S.reduceK = 4 + nextRandom (&state) % 5; }
+
+  pthread_t* handles = zeroed (nThreads, sizeof (pthread_t));
+  for (i = 1; i < nThreads; i++)                                           // All threads must start, or the others
+    if (pthread_create (&handles[i], NULL, work, &P.threads[i]))           // wait at the barrier forever
+      printf ("c CANNOT CREATE THREAD %i\n", i), exit (ERROR);
+  work (&P.threads[0]);
+  for (i = 1; i < nThreads; i++) pthread_join (handles[i], NULL);
+
+  *S = P.threads[0].S;                                                     // S shares its arrays with thread 0, which
+  S->exportLemma = NULL; S->maxConflicts = maxConflicts;                   // may have resized the DB
+  for (i = 0; i < nThreads && result == UNKNOWN; i++) {                    // The first thread (by id) that finished
+    result = P.threads[i].result;                                          // in the last period decides the result
+    if (result == SAT && i) memcpy (S->model, P.threads[i].S.model, sizeof (int) * (S->nVars + 1)); }
+  for (i = 0; i < nThreads; i++) {
+    if (i) freeSolver (&P.threads[i].S);
+    free (P.threads[i].exported); }
+  pthread_barrier_destroy (&P.barrier); free (handles); free (P.threads);
+  return result; }
@@ -0,0 +1,236 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "microsat.h"
+
+enum PREPROCESS { MAX_OCCURS = 1000, MAX_PAIRS = 256, MAX_RESOLVENT = 16, MAX_ROUNDS = 3, EFFORT = 1 << 20 };
+                                      // Bounds of the subsumption candidates, of variable elimination and of the work
+struct preprocessor {                 // The irredundant clauses outside of the DB: clause c has size[c] literals at
+  struct solver* S;                   // lits + start[c]; size[c] < 0 means removed
+  int nClauses, maxClauses, *start, *size, nLits, maxLits, *lits;
+  unsigned *signature;                // A bit per variable (modulo 32) of clause c, to filter subsumption candidates
+  struct list *occurs, queue, candidates, stack;  // Per literal the clauses that contain it, the clauses to check for
+  int *frozen, *touched, round;       // subsumption, and the clauses of eliminated variables; variables are
+  int *mark, stamp, *processed, changed; // eliminated if touched in the previous round
+  int full;                           // Strengthen, derive units and eliminate (0: keep the answers of queries)
+  long subsumptions, resolutions; };  // The remaining work: candidates of subsumption and pairs of resolution
+
+static void unlinkClause (struct list* list, int c) {              // Remove clause c from an occurrence list
+  for (int i = 0; i < list->size; i++)
+    if (list->data[i] == c) { list->data[i] = list->data[--list->size]; return; } }
+
+static int* literals (struct preprocessor* P, int c) { return P->lits + P->start[c]; }
+
+static void touch (struct preprocessor* P, int c) {          // Update the signature of c and touch its variables
+  int* clause = literals (P, c); P->signature[c] = 0;
+  for (int i = 0; i < P->size[c]; i++)
+    P->signature[c] |= 1u << (abs (clause[i]) & 31), P->touched[abs (clause[i])] = P->round + 1; }
+
+static void unit (struct preprocessor* P, int lit) {         // Assign a derived unit at the top level
+  struct solver* S = P->S;
+  if (S->false[-lit]) return;
+  if (S->false[lit]) { P->changed = UNSAT; return; }         // Remember the conflict in changed
+  S->unit[abs (lit)] = lit; assign (S, &S->unit[abs (lit)], 1); }
+
+static void removeClause (struct preprocessor* P, int c) {   // The occurrence lists are cleaned lazily
+  touch (P, c); P->size[c] = -1; if (P->changed != UNSAT) P->changed = 1; }
+
+static void strengthen (struct preprocessor* P, int c, int lit) { // Remove lit from clause c
+  int i, *clause = literals (P, c);
+  for (i = 0; clause[i] != lit; i++);
+  for (; i < P->size[c] - 1; i++) clause[i] = clause[i+1];
+  P->touched[abs (lit)] = P->round + 1;
+  if (--P->size[c] > 1) touch (P, c);
+  if (P->size[c] == 1) unit (P, clause[0]), removeClause (P, c);
+  else if (!P->size[c]) P->changed = UNSAT;
+  else if (P->changed != UNSAT) P->changed = 1, push (&P->queue, c); }
+
+static int newClause (struct preprocessor* P, int* in, int size) { // Add a clause; units are assigned instead
+  if (size == 1) { unit (P, in[0]); return -1; }
+  if (P->nClauses == P->maxClauses) {
+    P->maxClauses = 2 * P->maxClauses + 1;
+    P->start = reallocate (P->start, sizeof (int) * P->maxClauses);
+    P->size  = reallocate (P->size,  sizeof (int) * P->maxClauses);
+    P->signature = reallocate (P->signature, sizeof (unsigned) * P->maxClauses); }
+  while (P->nLits + size > P->maxLits) {
+    P->maxLits = 2 * P->maxLits + 1; P->lits = reallocate (P->lits, sizeof (int) * P->maxLits); }
+  int c = P->nClauses++;
+  P->start[c] = P->nLits; P->size[c] = size; P->nLits += size;
+  for (int i = 0; i < size; i++) P->lits[P->start[c] + i] = in[i], push (&P->occurs[in[i]], c);
+  touch (P, c); push (&P->queue, c);
+  return c; }
+
+static void propagateUnits (struct preprocessor* P) {        // Simplify the clauses with the new top-level units
+  struct solver* S = P->S;
+  while (P->processed < S->assigned && P->changed != UNSAT) {
+    int lit = *(P->processed++), i;                          // lit is false, -lit is true
+    struct list* satisfied = &P->occurs[-lit], *falsified = &P->occurs[lit];
+    for (i = 0; i < satisfied->size; i++)
+      if (P->size[satisfied->data[i]] >= 0) removeClause (P, satisfied->data[i]);
+    satisfied->size = 0;
+    while (falsified->size) {                                // strengthen unlinks the clause from its list
+      int c = falsified->data[--falsified->size];
+      if (P->size[c] >= 0) strengthen (P, c, lit); } } }
+
+static int subsumes (struct preprocessor* P, int c, int d, int* flip) { // Does c subsume d, possibly with one literal
+  int i, *a = literals (P, c), *b = literals (P, d);         // of c negated in d (stored in flip)?
+  P->stamp++; *flip = 0;
+  for (i = 0; i < P->size[d]; i++) P->mark[b[i]] = P->stamp;
+  for (i = 0; i < P->size[c]; i++) {
+    if (P->mark[a[i]] == P->stamp) continue;
+    if (!*flip && P->mark[-a[i]] == P->stamp) { *flip = a[i]; continue; }
+    return 0; }
+  return 1; }
+
+static void subsume (struct preprocessor* P, int c) {        // Remove the clauses subsumed by c and strengthen the
+  int i, lit = 0, best = MAX_OCCURS, *clause = literals (P, c); // clauses that c self-subsumes
+  for (i = 0; i < P->size[c]; i++) {                         // Each candidate contains the literal of c with the
+    int n = P->occurs[clause[i]].size + P->occurs[-clause[i]].size;  // fewest occurrences, or its negation
+    if (n < best) best = n, lit = clause[i]; }
+  if (!lit) return;
+  P->candidates.size = 0;                                    // The strengthened clauses are collected first, as
+  for (int sign = 1; sign >= -1; sign -= 2) {                // strengthening changes the occurrence lists
+    struct list* list = &P->occurs[sign * lit]; P->subsumptions -= list->size;
+    for (i = 0; i < list->size; i++) {
+      int d = list->data[i], flip;
+      if (d == c || P->size[d] < P->size[c] || (P->signature[c] & ~P->signature[d]) || !subsumes (P, c, d, &flip)) continue;
+      if (!flip) removeClause (P, d);
+      else if (P->full) push (&P->candidates, d); } }       // Only if full: strengthening propagates more than
+  for (i = 0; i < P->candidates.size && P->size[c] >= 0 && P->changed != UNSAT; i++) { // the original formula
+    int d = P->candidates.data[i], flip, size = P->size[d];
+    if (size < 0 || !subsumes (P, c, d, &flip) || !flip) continue;
+    unlinkClause (&P->occurs[-flip], d); strengthen (P, d, -flip);  // d without -flip subsumes c if both had the same size
+    if (size == P->size[c] && P->size[c] >= 0) removeClause (P, c); } }
+
+static int resolve (struct preprocessor* P, int c, int d, int var, int* out) { // The resolvent of c and d on var in out:
+  int i, n = 0, *a = literals (P, c), *b = literals (P, d);            // its size or -1 for a tautology
+  P->stamp++;
+  for (i = 0; i < P->size[c]; i++)
+    if (abs (a[i]) != var) P->mark[a[i]] = P->stamp, out[n++] = a[i];
+  for (i = 0; i < P->size[d]; i++) {
+    if (abs (b[i]) == var || P->mark[b[i]] == P->stamp) continue;
+    if (P->mark[-b[i]] == P->stamp) return -1;
+    out[n++] = b[i]; }
+  return n; }
+
+static void clean (struct preprocessor* P, struct list* list) { // Drop the removed clauses from an occurrence list
+  int i, j = 0;
+  for (i = 0; i < list->size; i++) if (P->size[list->data[i]] >= 0) list->data[j++] = list->data[i];
+  list->size = j; }
+
+static void eliminate (struct preprocessor* P, int var) {    // Replace the clauses of var by their resolvents if
+  struct solver* S = P->S;                                   // this does not increase the number of clauses
+  struct list *pos = &P->occurs[var], *neg = &P->occurs[-var];
+  int i, j, n, count = 0, *out = S->buffer;
+  clean (P, pos); clean (P, neg);
+  if (pos->size * neg->size > MAX_PAIRS) return;
+  P->resolutions -= pos->size * neg->size;
+  for (i = 0; i < pos->size; i++)                            // First count the resolvents
+    for (j = 0; j < neg->size; j++) {
+      if ((n = resolve (P, pos->data[i], neg->data[j], var, out)) < 0) continue;
+      if (n > MAX_RESOLVENT || ++count > pos->size + neg->size) return; }
+  for (i = 0; i < pos->size; i++)                            // Then add them (the resolvents do not contain var)
+    for (j = 0; j < neg->size && P->changed != UNSAT; j++) {
+      if ((n = resolve (P, pos->data[i], neg->data[j], var, out)) == 0) P->changed = UNSAT;
+      if (n > 0) newClause (P, out, n); }
+  for (struct list* list = pos; list; list = (list == pos) ? neg : NULL) {
+    for (i = 0; i < list->size; i++) {                       // Save the clauses for the model reconstruction as
+      int c = list->data[i], *clause = literals (P, c);      // [witness, other literals..., size]
+      push (&P->stack, list == pos ? var : -var);
+      for (j = 0; j < P->size[c]; j++) if (abs (clause[j]) != var) push (&P->stack, clause[j]);
+      push (&P->stack, P->size[c]);
+      removeClause (P, c); }
+    list->size = 0; }
+  P->changed = (P->changed == UNSAT) ? UNSAT : 1;
+  propagateUnits (P); }
+
+int preprocess (struct solver* S, int* frozen, int nFrozen, int full) { // Simplify the irredundant clauses
+  if (propagate (S) == UNSAT) return UNSAT;                  // Propagate the top-level units to a fixpoint first
+  STATS (double start = seconds ());
+  int i, j, n = S->nVars, from = S->mem_clauses;
+  struct preprocessor* P = zeroed (1, sizeof (struct preprocessor));
+  P->S = S; P->processed = S->assigned; P->full = full;
+  P->occurs = (struct list*) zeroed (2*n+1, sizeof (struct list)) + n;
+  P->mark   = (int*) zeroed (2*n+1, sizeof (int)) + n;
+  P->frozen = zeroed (n+1, sizeof (int)); P->touched = zeroed (n+1, sizeof (int));
+  P->round  = -1;                                            // All variables are candidates in the first round
+  for (i = 0; i < nFrozen; i++) P->frozen[abs (frozen[i])] = 1;
+
+  int size; for (i = from + 2; i < S->mem_fixed; i += size + 3) { // Size the occurrence lists and the clause arrays
+    for (size = 0; S->DB[i+size]; size++) P->occurs[S->DB[i+size]].capacity++;
+    P->maxClauses++; P->maxLits += size; }
+  for (i = -n; i <= n; i++)                                  // (empty lists stay NULL until push)
+    if (P->occurs[i].capacity) P->occurs[i].data = reallocate (NULL, sizeof (int) * P->occurs[i].capacity);
+  P->start = reallocate (NULL, sizeof (int) * ++P->maxClauses); P->size = reallocate (NULL, sizeof (int) * P->maxClauses);
+  P->signature = reallocate (NULL, sizeof (unsigned) * P->maxClauses); P->lits = reallocate (NULL, sizeof (int) * ++P->maxLits);
+  for (i = from + 2; i < S->mem_fixed; i += size + 3) {      // Copy the clauses without the top-level units
+    int* clause = S->DB + i, satisfied = 0, k = 0;
+    for (size = 0; clause[size]; size++);
+    P->stamp++;
+    for (j = 0; j < size && !satisfied; j++) {
+      int lit = clause[j];
+      if (S->false[-lit] || P->mark[-lit] == P->stamp) satisfied = 1;   // Skip satisfied clauses and tautologies
+      else if (!S->false[lit] && P->mark[lit] != P->stamp) P->mark[lit] = P->stamp, S->buffer[k++] = lit; }
+    if (!satisfied && !k) P->changed = UNSAT;
+    if (!satisfied && k) newClause (P, S->buffer, k); }
+  propagateUnits (P);
+
+  P->subsumptions = P->resolutions = P->nLits / 2 + EFFORT;   // Bound the work by the size of the formula
+  for (P->round = 0; P->round < MAX_ROUNDS && P->changed != UNSAT && (P->round == 0 || P->changed); P->round++) {
+    P->changed = 0;
+    for (i = 0; i < P->queue.size && P->changed != UNSAT && P->subsumptions > 0; i++) { // Subsumption and strengthening of the new and
+      int c = P->queue.data[i];                              // the strengthened clauses
+      if (P->size[c] >= 0) subsume (P, c);
+      propagateUnits (P); }
+    P->queue.size = 0;
+    for (i = 1; i <= n && full && P->changed != UNSAT && P->resolutions > 0; i++) // Bounded variable elimination
+      if (P->touched[i] >= P->round && !P->frozen[i] && !S->false[i] && !S->false[-i]) eliminate (P, i); }
+
+  int result = (P->changed == UNSAT) ? UNSAT : SAT;
+  if (result == SAT) {                                       // Replace the clauses in the DB
+    S->mem_used = S->mem_fixed = from; S->nLemmas = 0; S->nClauses = 0;
+    freeCompletion (S);                                      // The counters of the buildability check are stale
+#ifdef LINKED_WATCHES
+    for (i = 1; i <= n; i++) S->first[i] = S->first[-i] = END;
+#else
+    for (i = -n; i <= n; i++) S->watches[i].size = S->binaries[i].size = 0;
+#endif
+    for (int* p = S->falseStack; p < S->assigned; p++) {     // The old unit clauses are gone: the reasons of the
+      int var = abs (*p); S->unit[var] = -*p;                // top-level literals become their unit cells
+      S->reason[var] = 1 + (int) (S->unit + var - S->DB); }
+    for (i = 0; i < P->nClauses; i++)
+      if (P->size[i] >= 0) storeClause (S, literals (P, i), P->size[i], 1), S->nClauses++;
+    watchClauses (S, from);
+    S->forced = S->processed = S->assigned;                  // All top-level units are already simplified away
+    S->nEliminated = P->stack.size; S->eliminated = P->stack.data; P->stack.data = NULL; }
+
+  for (i = -n; i <= n; i++) free (P->occurs[i].data);
+  free (P->occurs - n); free (P->mark - n); free (P->frozen); free (P->touched); free (P->signature);
+  free (P->start); free (P->size); free (P->lits); free (P->queue.data); free (P->candidates.data); free (P->stack.data);
+  free (P);
+  STATS (S->stats.preprocess = seconds () - start);
+  return result; }
+
+void extendModel (struct solver* S) {                        // Set the eliminated variables of S->model in the
+  int* p = S->eliminated + S->nEliminated;                   // reverse order of the elimination: flip the witness
+  while (p > S->eliminated) {                                // of each clause that the model falsifies
+    int size = *(--p), i; p -= size;
+    for (i = 0; i < size; i++) if (S->model[abs (p[i])] == (p[i] > 0)) break;
+    if (i == size) S->model[abs (p[0])] = (p[0] > 0); } }
+
+void extendImplied (struct solver* S) {                      // Propagate the trail through the saved clauses, which
+  int* p = S->eliminated + S->nEliminated;                   // are unit only on their witness (in reverse order)
+  while (p > S->eliminated) {
+    int size = *(--p), i, var = abs (p[-size]); p -= size;
+    if (S->false[var] || S->false[-var]) continue;
+    for (i = 1; i < size && S->false[p[i]]; i++);
+    if (i == size) S->unit[var] = p[0], assign (S, &S->unit[var], 1); } }
+
+int eliminatedSatisfied (struct solver* S) {                 // Do the saved clauses hold in the completion of the
+  int* p = S->eliminated + S->nEliminated;                   // trail, i.e., with the undecided variables false?
+  while (p > S->eliminated) {
+    int size = *(--p), i; p -= size;
+    for (i = 0; i < size && !S->false[-p[i]] && (p[i] > 0 || S->false[p[i]]); i++);
+    if (i == size) return 0; }
+  return 1; }